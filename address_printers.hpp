@@ -0,0 +1,198 @@
+
+#ifndef ML__PRINTERS__ADDRESS_PRINTERS_HPP
+#define ML__PRINTERS__ADDRESS_PRINTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+#include "printer_tables.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// Texts of all 256 octets, as they appear in IPv4 addresses.
+struct ipv4_octet_table
+{
+	/// Text of every octet, followed by a dot (and padded with zeros), so
+	/// it is always copied by a single 4-byte move.
+	char texts[ 256 ][ 4 ];
+
+	/// Count of digits of every octet.
+	unsigned char lengths[ 256 ];
+};
+
+/// Calculates texts of all octets.
+constexpr ipv4_octet_table calculate_ipv4_octet_table() {
+	ipv4_octet_table table{};
+	for ( int octet = 0; octet < 256; ++octet ) {
+		int L = 0;  // Current length of the text
+		if ( octet >= 100 )
+			table.texts[ octet ][ L++ ] = (char)('0' + octet / 100);
+		if ( octet >= 10 )
+			table.texts[ octet ][ L++ ] = (char)('0' + octet / 10 % 10);
+		table.texts[ octet ][ L++ ] = (char)('0' + octet % 10);
+		table.lengths[ octet ] = (unsigned char)L;
+		table.texts[ octet ][ L ] = '.';
+	}
+	return table;
+}
+
+/// Holder of the precomputed octets table.
+/// It is a template, so the table can be defined in a header.
+template< typename Dummy = void >
+struct precomputed_ipv4_octets
+{
+	static constexpr ipv4_octet_table table = calculate_ipv4_octet_table();
+};
+
+template< typename Dummy >
+constexpr ipv4_octet_table precomputed_ipv4_octets< Dummy >::table;
+
+
+/// This class prints IPv4 addresses in dotted-decimal notation.
+/// Every octet (with the following dot) is copied from the precomputed
+/// table by a single 4-byte move.
+class ipv4_printer
+{
+public:
+	typedef ipv4_printer this_type;
+
+	/// Maximal length of a printed address.
+	static constexpr int LENGTH_MAX = 15;
+
+	/// Minimal size of buffers, passed for printing. Last octet is copied
+	/// together with its padding, so there must be no less room than for
+	/// the longest address with null-character.
+	static constexpr int BUFFER_SIZE_MIN = LENGTH_MAX + 1;
+
+protected:
+	const ipv4_octet_table* _octets = &precomputed_ipv4_octets<>::table;
+
+	/// Prints one octet and, if 'with_dot', the following dot.
+	/// Returns pointer past the printed characters.
+	char* print_octet( uint8_t octet, char* out, bool with_dot ) const {
+		memcpy( out, _octets->texts[ octet ], 4 );
+		return out + _octets->lengths[ octet ] + (int)with_dot;
+	}
+
+public:
+	/// Prints 'address' (given as 4 bytes in network order) into buffer
+	/// 'buf' (of at least 'BUFFER_SIZE_MIN' characters), and appends
+	/// null-character.
+	/// Returns number of characters printed (null-character not included).
+	int print( const uint8_t* address, char* buf ) const {
+		char* out = buf;
+		out = print_octet( address[ 0 ], out, true );
+		out = print_octet( address[ 1 ], out, true );
+		out = print_octet( address[ 2 ], out, true );
+		out = print_octet( address[ 3 ], out, false );
+		*out = '\0';
+		return (int)(out - buf);
+	}
+
+	/// Prints 'address', given as an integer in host order (so 0x7f000001
+	/// is "127.0.0.1").
+	int print( uint32_t address, char* buf ) const {
+		const uint8_t bytes[ 4 ] = { (uint8_t)(address >> 24), (uint8_t)(address >> 16),
+				(uint8_t)(address >> 8), (uint8_t)address };
+		return print( bytes, buf );
+	}
+};
+
+
+/// This class prints IPv6 addresses in the canonical text form of RFC 5952:
+/// groups in lower-case hex without leading zeros, the longest run (the
+/// first one, if several) of 2 or more zero groups replaced by "::", and
+/// IPv4-mapped addresses printed as "::ffff:a.b.c.d".
+/// Hex digits are taken from the precomputed table of base-16 digit pairs,
+/// so every byte is a single 2-byte copy, and every group is written by a
+/// single 4-byte move.
+class ipv6_printer
+{
+public:
+	typedef ipv6_printer this_type;
+
+	/// Maximal length of a printed address.
+	static constexpr int LENGTH_MAX = 45;
+
+	/// Minimal size of buffers, passed for printing.
+	static constexpr int BUFFER_SIZE_MIN = LENGTH_MAX + 1;
+
+protected:
+	/// Pairs of hex digits, i.e. texts of all bytes.
+	const char* _hex_pairs = get_precomputed_default_pairs< char >( 16 );
+
+	/// Printer of embedded IPv4 addresses.
+	ipv4_printer _ipv4_printer;
+
+	/// Prints 'group' without leading zeros. All 4 characters are written by
+	/// a single move (so characters past the digits are overwritten later).
+	/// Returns pointer past the printed digits.
+	char* print_group( unsigned group, char* out ) const {
+		char digits[ 8 ] = {};
+		memcpy( digits, _hex_pairs + 2 * (group >> 8), 2 );
+		memcpy( digits + 2, _hex_pairs + 2 * (group & 0xff), 2 );
+		const int length = 1 + (int)(group > 0xf) + (int)(group > 0xff)
+				+ (int)(group > 0xfff);
+		memcpy( out, digits + 4 - length, 4 );
+		return out + length;
+	}
+
+public:
+	/// Prints 'address' (given as 16 bytes in network order) into buffer
+	/// 'buf' (of at least 'BUFFER_SIZE_MIN' characters), and appends
+	/// null-character.
+	/// Returns number of characters printed (null-character not included).
+	int print( const uint8_t* address, char* buf ) const {
+		unsigned groups[ 8 ];
+		for ( int i = 0; i < 8; ++i )
+			groups[ i ] = ((unsigned)address[ 2 * i ] << 8) | address[ 2 * i + 1 ];
+		// Find the longest run of zero groups
+		int best_start = -1, best_length = 1;  // Single group is not replaced
+		for ( int i = 0; i < 8; ) {
+			if ( groups[ i ] != 0 ) {
+				++i;
+				continue;
+			}
+			int j = i + 1;
+			while ( j < 8 && groups[ j ] == 0 )
+				++j;
+			if ( j - i > best_length ) {
+				best_start = i;
+				best_length = j - i;
+			}
+			i = j;
+		}
+		char* out = buf;
+		// IPv4-mapped address
+		if ( best_start == 0 && best_length == 5 && groups[ 5 ] == 0xffff ) {
+			memcpy( out, "::ffff:", 7 );
+			out += 7;
+			out += _ipv4_printer.print( address + 12, out );
+			return (int)(out - buf);
+		}
+		// Regular address
+		for ( int i = 0; i < 8; ++i ) {
+			if ( i == best_start ) {
+				*(out++) = ':';
+				if ( i == 0 )
+					*(out++) = ':';
+				i += best_length - 1;
+				continue;
+			}
+			out = print_group( groups[ i ], out );
+			if ( i < 7 )
+				*(out++) = ':';
+		}
+		*out = '\0';
+		return (int)(out - buf);
+	}
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__ADDRESS_PRINTERS_HPP
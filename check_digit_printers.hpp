@@ -0,0 +1,285 @@
+
+#ifndef ML__PRINTERS__CHECK_DIGIT_PRINTERS_HPP
+#define ML__PRINTERS__CHECK_DIGIT_PRINTERS_HPP
+
+#include <algorithm>
+#include <limits>
+#include <cstring>
+#include <cassert>
+
+#include "printer_tables.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// Values of some function for all pairs of decimal digits.
+struct decimal_pair_table
+{
+	unsigned char values[ 100 ];
+};
+
+/// Calculates table of 'weight_first * a + weight_second * b' for all pairs
+/// of digits (a, b). If 'sum_digits', products above 9 are replaced by sum
+/// of their digits (as Luhn algorithm requires).
+constexpr decimal_pair_table calculate_decimal_pair_table(
+		int weight_first, int weight_second, bool sum_digits ) {
+	decimal_pair_table table{};
+	for ( int a = 0; a < 10; ++a ) {
+		for ( int b = 0; b < 10; ++b ) {
+			int first = weight_first * a, second = weight_second * b;
+			if ( sum_digits ) {
+				first = first / 10 + first % 10;
+				second = second / 10 + second % 10;
+			}
+			table.values[ 10 * a + b ] = (unsigned char)(first + second);
+		}
+	}
+	return table;
+}
+
+/// Holder of the precomputed pairs tables.
+/// It is a template, so the tables can be defined in a header.
+template< int WeightFirst, int WeightSecond, bool SumDigits >
+struct precomputed_decimal_pairs
+{
+	static constexpr decimal_pair_table table
+			= calculate_decimal_pair_table( WeightFirst, WeightSecond, SumDigits );
+};
+
+template< int WeightFirst, int WeightSecond, bool SumDigits >
+constexpr decimal_pair_table
+		precomputed_decimal_pairs< WeightFirst, WeightSecond, SumDigits >::table;
+
+
+/// Algorithms of check digits.
+/// Every algorithm receives digits from left to right: possibly a single
+/// digit at first, and then pairs, so that the last pair ends at the last
+/// digit. Thus position (from the right) of every received digit is known
+/// by its position in the pair.
+/// Every algorithm defines:
+///    'state' - data accumulated during printing,
+///    'CHECK_LENGTH' - count of check characters,
+///    'add_digit()' - accumulates the single first digit,
+///    'add_pair()' - accumulates a pair of digits (given as 0..99),
+///    'check_value()' - calculates the check value from the state,
+///    'print_check()' - prints the check value.
+
+/// Luhn algorithm (payment card numbers, IMEI): starting from the last
+/// digit, every second digit is doubled (summing digits of the result).
+struct luhn_algorithm
+{
+	struct state {
+		unsigned sum = 0;
+	};
+
+	static constexpr int CHECK_LENGTH = 1;
+
+	static void add_digit( state& st, int digit )
+		{ st.sum += precomputed_decimal_pairs< 1, 2, true >::table.values[ digit ]; }
+	static void add_pair( state& st, int pair )
+		{ st.sum += precomputed_decimal_pairs< 1, 2, true >::table.values[ pair ]; }
+	static int check_value( const state& st )
+		{ return (int)((10 - st.sum % 10) % 10); }
+	static char* print_check( int check, char* out )
+		{ *out = (char)('0' + check);
+		  return out + 1; }
+};
+
+/// EAN / GTIN algorithm (EAN-8, UPC-A, EAN-13, ISBN-13, GTIN-14): starting
+/// from the last digit, digits have weights 3 and 1 alternately.
+struct ean_algorithm
+{
+	struct state {
+		unsigned sum = 0;
+	};
+
+	static constexpr int CHECK_LENGTH = 1;
+
+	static void add_digit( state& st, int digit )
+		{ st.sum += precomputed_decimal_pairs< 1, 3, false >::table.values[ digit ]; }
+	static void add_pair( state& st, int pair )
+		{ st.sum += precomputed_decimal_pairs< 1, 3, false >::table.values[ pair ]; }
+	static int check_value( const state& st )
+		{ return (int)((10 - st.sum % 10) % 10); }
+	static char* print_check( int check, char* out )
+		{ *out = (char)('0' + check);
+		  return out + 1; }
+};
+
+/// ISBN-10 algorithm: digits have weights 2, 3, ... starting from the last
+/// one, and the sum is taken modulo 11 (check value 10 is printed as 'X').
+/// Weighted sum is accumulated as sum of all prefix sums, so weights don't
+/// depend on the length: after pair (a, b) the prefix sum 'P' grows by
+/// 'a + b', and the total 'T' by '2P + 2a + b'.
+struct isbn10_algorithm
+{
+	struct state {
+		unsigned prefix_sum = 0;
+		unsigned total = 0;
+	};
+
+	static constexpr int CHECK_LENGTH = 1;
+
+	static void add_digit( state& st, int digit )
+		{ st.prefix_sum += digit;
+		  st.total += st.prefix_sum; }
+	static void add_pair( state& st, int pair )
+		{ st.total += 2 * st.prefix_sum
+				+ precomputed_decimal_pairs< 2, 1, false >::table.values[ pair ];
+		  st.prefix_sum += precomputed_decimal_pairs< 1, 1, false >::table.values[ pair ]; }
+	static int check_value( const state& st )
+		{ return (int)((11 - (st.total + st.prefix_sum) % 11) % 11); }
+	static char* print_check( int check, char* out )
+		{ *out = check == 10 ? 'X' : (char)('0' + check);
+		  return out + 1; }
+};
+
+/// ISO 7064 MOD 97-10 algorithm (as used in IBAN): 2 check digits, such
+/// that the number followed by them gives remainder 1 modulo 97.
+/// Remainder is accumulated by pairs: as 100 = 3 (mod 97), every pair
+/// changes it to '3 * r + pair', which is reduced by a single comparison
+/// loop instead of a division.
+struct mod97_algorithm
+{
+	struct state {
+		unsigned remainder = 0;
+	};
+
+	static constexpr int CHECK_LENGTH = 2;
+
+	static void add_digit( state& st, int digit )
+		{ st.remainder = (unsigned)digit; }
+	static void add_pair( state& st, int pair ) {
+		unsigned r = 3 * st.remainder + (unsigned)pair;  // Less than 4 * 97
+		while ( r >= 97 )
+			r -= 97;
+		st.remainder = r;
+	}
+	static int check_value( const state& st )
+		{ return (int)(98 - 3 * st.remainder % 97); }
+	static char* print_check( int check, char* out )
+		{ memcpy( out, get_precomputed_default_pairs< char >( 10 ) + 2 * check, 2 );
+		  return out + 2; }
+};
+
+
+/// This printer outputs natural numbers in base 10, computing their check
+/// digit (or digits) by 'CheckAlgorithm' in the same left-to-right pass,
+/// and optionally appending it.
+/// Digits are obtained in pairs, as 'lr_printer_2_digits' does, and every
+/// pair is accumulated into the checksum by a lookup of a precomputed
+/// table, so the printed text is never scanned again.
+/// Numbers can be padded with leading zeros to a fixed width (as required
+/// by EAN codes, ISBNs and account numbers).
+template< typename NumberType, typename CheckAlgorithm >
+class check_digit_printer
+{
+public:
+	typedef NumberType number_type;
+	typedef CheckAlgorithm algorithm_type;
+	typedef check_digit_printer< NumberType, CheckAlgorithm > this_type;
+
+	static_assert( has_precomputed_powers< NumberType >::value,
+			"Check digit printer requires a bounded integer type." );
+
+	/// Maximal count of characters printed for any number.
+	static constexpr int MAX_LENGTH
+			= std::numeric_limits< number_type >::digits10 + 1 + CheckAlgorithm::CHECK_LENGTH;
+
+protected:
+	/// Minimal count of printed digits (without the check ones).
+	short _width;
+
+	/// Powers of 10.
+	const number_type* _powers = get_precomputed_powers< number_type >( 10 );
+
+	/// Count of powers of 10, which fit in 'number_type'.
+	const short _powers_length = get_precomputed_powers_length< number_type >( 10 );
+
+	/// Pairs of decimal digits, "000102...99".
+	const char* _pairs = get_precomputed_default_pairs< char >( 10 );
+
+protected:
+	/// This is the base printing routine: prints digits of 'x' into 'out',
+	/// and accumulates them into 'st'.
+	/// Returns pointer past the last printed digit.
+	char* print_to( number_type x, char* out, typename CheckAlgorithm::state& st ) const {
+		assert( x >= 0 );
+		// Count of digits, obtained without branches
+		short length = 1;
+		for ( short k = 1; k < _powers_length; ++k )
+			length += (short)(_powers[ k ] <= x);
+		length = std::max( length, _width );
+		short k = length - 1;  // Index of power of the current digit
+		if ( length & 1 ) {
+			// Odd count: the first digit alone
+			const int digit = (int)(x / _powers[ k ]);
+			*(out++) = _pairs[ 2 * digit + 1 ];
+			CheckAlgorithm::add_digit( st, digit );
+			x -= digit * _powers[ k ];
+			--k;
+		}
+		for ( ; k > 0; k -= 2 ) {
+			const int pair = (int)(x / _powers[ k - 1 ]);
+			assert( 0 <= pair && pair < 100 );
+			memcpy( out, _pairs + 2 * pair, 2 );
+			out += 2;
+			CheckAlgorithm::add_pair( st, pair );
+			x -= pair * _powers[ k - 1 ];
+		}
+		assert( x == 0 );
+		return out;
+	}
+
+public:
+	/// Constructor with specification of minimal count of printed digits
+	/// (without the check ones).
+	explicit check_digit_printer( short width_ = 0 )
+		{ set_width( width_ ); }
+
+	/// Setter / getter for the width.
+	void set_width( short width_ )
+		{ assert( 0 <= width_ && width_ <= _powers_length );
+		  _width = width_; }
+	short get_width() const
+		{ return _width; }
+
+	/// Returns the check value of 'x'.
+	int check_value( const number_type& x ) const
+		{ char buf[ MAX_LENGTH ];
+		  typename CheckAlgorithm::state st;
+		  print_to( x, buf, st );
+		  return CheckAlgorithm::check_value( st ); }
+
+	/// Prints integer 'x' into buffer 'buf', without the check digits, and
+	/// without appending null-character. Check value is stored in 'check'.
+	/// Returns pointer past the last printed digit.
+	char* print_digits( const number_type& x, char* buf, int& check ) const
+		{ typename CheckAlgorithm::state st;
+		  buf = print_to( x, buf, st );
+		  check = CheckAlgorithm::check_value( st );
+		  return buf; }
+
+	/// Prints integer 'x' into buffer 'buf', followed by the check digits,
+	/// without appending null-character.
+	/// Returns pointer past the last printed character.
+	char* print_digits( const number_type& x, char* buf ) const
+		{ int check;
+		  buf = print_digits( x, buf, check );
+		  return CheckAlgorithm::print_check( check, buf ); }
+
+	/// Prints integer 'x' into buffer 'buf', followed by the check digits,
+	/// and appends null-character.
+	/// Returns number of characters printed (null-character not included).
+	int print( const number_type& x, char* buf ) const
+		{ char* buf_end = print_digits( x, buf );
+		  *buf_end = '\0';
+		  return (int)(buf_end - buf); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__CHECK_DIGIT_PRINTERS_HPP
@@ -0,0 +1,17 @@
+# Prints size of code (all '.text' sections) of an object file, and how 
+# much of it is cold ('.text.unlikely' sections).
+# Usage: cmake -DSIZE_TOOL=<path to 'size'> -DOBJECT=<object file> -P code_size.cmake
+
+execute_process( COMMAND ${SIZE_TOOL} -A ${OBJECT} OUTPUT_VARIABLE sections )
+string( REGEX MATCHALL "\n\\.text[^ \t\n]*[ \t]+[0-9]+" text_sections "${sections}" )
+set( total 0 )
+set( cold 0 )
+foreach( section ${text_sections} )
+	string( REGEX MATCH "[0-9]+$" section_size "${section}" )
+	math( EXPR total "${total} + ${section_size}" )
+	if ( section MATCHES "^\n\\.text\\.unlikely" )
+		math( EXPR cold "${cold} + ${section_size}" )
+	endif()
+endforeach()
+get_filename_component( name ${OBJECT} NAME )
+message( "${name}: ${total} bytes of code, ${cold} of them cold" )
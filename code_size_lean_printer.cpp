@@ -0,0 +1,29 @@
+
+/// Instantiates printing of all integer types by 'lean_printer', so
+/// the code size can be compared with 'lr_printer_2_digits' (see the 'code_size'
+/// target).
+
+#include <iostream>
+#include <cstdio>
+
+#include "lean_printer.hpp"
+
+template< typename NumberType >
+int print_by_all_overloads( NumberType x, char* buf )
+{
+	ml::printers::lean_printer< NumberType > printer;
+	printer.print( x, stdout );
+	printer.print( x, std::cout );
+	return printer.print( x, buf );
+}
+
+int print_all_integer_types( char* buf )
+{
+	return print_by_all_overloads< unsigned char >( 255, buf )
+		+ print_by_all_overloads< short >( 32'767, buf )
+		+ print_by_all_overloads< unsigned short >( 65'535, buf )
+		+ print_by_all_overloads< int >( 2'147'483'647, buf )
+		+ print_by_all_overloads< unsigned >( 4'294'967'295u, buf )
+		+ print_by_all_overloads< long long >( 9'223'372'036'854'775'807LL, buf )
+		+ print_by_all_overloads< unsigned long long >( 18'446'744'073'709'551'615ULL, buf );
+}
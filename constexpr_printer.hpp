@@ -0,0 +1,215 @@
+
+#ifndef ML__PRINTERS__CONSTEXPR_PRINTER_HPP
+#define ML__PRINTERS__CONSTEXPR_PRINTER_HPP
+
+#include <string>
+#include <limits>
+#include <cassert>
+#include <ostream>
+#include <type_traits>
+
+#include "printer_tables.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// Here is printing, which can be done in constant expressions, so numeric
+/// literals of constants, enum values or generated headers are obtained at
+/// compile time, and are placed in read-only data of the binary.
+/// It uses the same precomputed tables as the printers (powers and pairs of
+/// the default alphabet), which are also calculated at compile time.
+
+
+/// Array of characters with fixed capacity, which (unlike 'std::array' before
+/// C++17) can be filled in constant expressions.
+/// The characters are always followed by null-character.
+template< int Capacity >
+class char_array
+{
+public:
+	typedef char_array< Capacity > this_type;
+
+	/// Maximal count of characters.
+	static constexpr int CAPACITY = Capacity;
+
+protected:
+	/// The characters, and null-character after them.
+	char _data[ Capacity + 1 ];
+
+	/// Count of the characters.
+	int _length;
+
+public:
+	/// Constructs an empty array.
+	constexpr char_array()
+		: _data{}, _length( 0 )
+		{}
+
+	/// Constructs a copy of array 'other' of not greater capacity, so
+	/// arrays of different lengths can be placed in one table.
+	template< int OtherCapacity >
+	constexpr char_array( const char_array< OtherCapacity >& other )
+		: _data{}, _length( other.size() ) {
+		static_assert( OtherCapacity <= Capacity,
+				"Capacity of the copied array is too large." );
+		for ( int i = 0; i < _length; ++i )
+			_data[ i ] = other[ i ];
+	}
+
+	/// Returns pointer to the characters, and past the last one.
+	constexpr const char* data() const
+		{ return _data; }
+	constexpr const char* c_str() const
+		{ return _data; }
+	constexpr const char* begin() const
+		{ return _data; }
+	constexpr const char* end() const
+		{ return _data + _length; }
+
+	/// Returns count of the characters.
+	constexpr int size() const
+		{ return _length; }
+
+	/// Returns the character at 'index'.
+	constexpr char operator[]( int index ) const
+		{ return _data[ index ]; }
+
+	/// Tells if the characters are equal to null-terminated 'str'.
+	constexpr bool equals( const char* str ) const {
+		for ( int i = 0; i < _length; ++i )
+			if ( str[ i ] != _data[ i ] )
+				return false;
+		return str[ _length ] == '\0';
+	}
+
+	/// Converts to string (at runtime).
+	std::string to_string() const
+		{ return std::string( _data, _length ); }
+
+	/// Returns pointers to the internal buffer, and past its end, for
+	/// filling it in by 'to_chars()'.
+	constexpr char* buffer_begin()
+		{ return _data; }
+	constexpr char* buffer_end()
+		{ return _data + Capacity; }
+
+	/// Sets count of the characters, after the buffer is filled in.
+	constexpr void set_length( int length_ )
+		{ _data[ length_ ] = '\0';
+		  _length = length_; }
+};
+
+template< int Capacity >
+constexpr int char_array< Capacity >::CAPACITY;
+
+template< int Capacity >
+inline std::ostream& operator<<( std::ostream& ostr, const char_array< Capacity >& a )
+	{ return ostr.write( a.data(), a.size() ); }
+
+
+/// Returns count of characters of 'x' in 'base', including the sign.
+template< typename NumberType >
+constexpr int calculate_chars_count( NumberType x, short base = 10 ) {
+	typedef typename std::make_unsigned< NumberType >::type unsigned_type;
+	int count = 1;
+	unsigned_type u = (unsigned_type)x;
+	if ( x < 0 ) {
+		u = (unsigned_type)(0 - u);
+		++count;
+	}
+	for ( ; u >= (unsigned_type)base; u /= (unsigned_type)base )
+		++count;
+	return count;
+}
+
+
+/// Prints 'x' in 'base' (from 2 to 36) with default alphabet, into range
+/// ['first', 'last'), preceded by '-' if negative. No null-character is
+/// appended.
+/// Digits are obtained from left to right, 2 at a time, by the precomputed
+/// powers of the base.
+/// Returns pointer past the last printed character, or 'nullptr' if the
+/// range is not enough.
+template< typename NumberType >
+constexpr char* to_chars( char* first, char* last, NumberType x, short base = 10 ) {
+	static_assert( std::is_integral< NumberType >::value,
+			"Only integers can be printed." );
+	typedef typename std::make_unsigned< NumberType >::type unsigned_type;
+	const unsigned_type* const powers
+			= precomputed_powers< unsigned_type >::tables.powers[ base ];
+	const short powers_length
+			= precomputed_powers< unsigned_type >::tables.lengths[ base ];
+	const char* const pairs
+			= precomputed_default_pairs< char >::tables.pairs
+			+ precomputed_default_pairs< char >::tables.offsets[ base ];
+	unsigned_type u = (unsigned_type)x;
+	if ( x < 0 ) {
+		if ( first == last )
+			return nullptr;
+		*(first++) = '-';
+		u = (unsigned_type)(0 - u);
+	}
+	// Index of power of the current digit
+	short k = 1;
+	while ( k < powers_length && powers[ k ] <= u )
+		++k;
+	--k;
+	if ( last - first < k + 1 )
+		return nullptr;
+	if ( (k & 1) == 0 ) {
+		// Odd count: the first digit alone
+		const unsigned digit = (unsigned)(u / powers[ k ]);
+		*(first++) = pairs[ 2 * digit + 1 ];
+		u -= digit * powers[ k ];
+		--k;
+	}
+	for ( ; k > 0; k -= 2 ) {
+		const unsigned pair = (unsigned)(u / powers[ k - 1 ]);
+		first[ 0 ] = pairs[ 2 * pair ];
+		first[ 1 ] = pairs[ 2 * pair + 1 ];
+		first += 2;
+		u -= pair * powers[ k - 1 ];
+	}
+	return first;
+}
+
+
+/// Capacity of 'char_array', enough for any value of 'NumberType' in any
+/// base: all binary digits, and the sign.
+template< typename NumberType >
+struct char_array_capacity
+	: std::integral_constant< int, std::numeric_limits< NumberType >::digits
+			+ 1 + std::is_signed< NumberType >::value >
+	{};
+
+/// Returns 'x' printed in 'base', in an array enough for any value of
+/// 'NumberType'.
+template< typename NumberType >
+constexpr char_array< char_array_capacity< NumberType >::value >
+		to_char_array( NumberType x, short base = 10 ) {
+	char_array< char_array_capacity< NumberType >::value > result;
+	const char* end = to_chars( result.buffer_begin(), result.buffer_end(), x, base );
+	assert( end != nullptr );
+	result.set_length( end != nullptr ? (int)(end - result.data()) : 0 );
+	return result;
+}
+
+
+/// Returns 'Value' printed in 'Base', in an array of exactly that many
+/// characters, e.g. 'constexpr auto s = to_array< 12345 >();'.
+template< long long Value, short Base = 10 >
+constexpr char_array< calculate_chars_count( Value, Base ) > to_array() {
+	static_assert( TABLES_BASE_MIN <= Base && Base <= TABLES_BASE_MAX,
+			"Base must be in range [2, 36]." );
+	char_array< calculate_chars_count( Value, Base ) > result;
+	const char* end = to_chars( result.buffer_begin(), result.buffer_end(), Value, Base );
+	result.set_length( (int)(end - result.data()) );
+	return result;
+}
+
+
+}
+}
+
+#endif // ML__PRINTERS__CONSTEXPR_PRINTER_HPP
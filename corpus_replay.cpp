@@ -0,0 +1,125 @@
+/// Replays values of a corpus, captured from a running process by
+/// 'value_capture.hpp', through the printers, and reports throughput of
+/// every printer on that data.
+/// Usage: corpus_replay <corpus file> [rounds]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+#include "value_capture.hpp"
+#include "modulo_printer_2_digits.hpp"
+#include "lr_printer_2_digits.hpp"
+#include "lean_printer.hpp"
+#include "memoizing_printer.hpp"
+#include "printer_composer.hpp"
+
+typedef std::chrono::steady_clock clock_type;
+
+/// Maximal base of the printers, which are based on 'lr_printer_2_digits'.
+const short LR_2_DIGITS_BASE_MAX = 10 + 6;
+
+/// Prints all 'entries' (of the same base) by printer 'p', separated by
+/// new-lines, 'rounds' times, and reports the fastest round.
+template< typename PrinterType >
+void replay( const char* name, PrinterType& p, 
+		const std::vector< ml::printers::corpus_entry >& entries, int rounds, 
+		std::vector< char >& out )
+{
+	clock_type::duration best = clock_type::duration::max();
+	size_t length = 0;
+	for ( int round = 0; round < rounds; ++round ) {
+		const clock_type::time_point start_time = clock_type::now();
+		char* ptr = out.data();
+		for ( const ml::printers::corpus_entry& entry : entries ) {
+			if ( entry.negative )
+				*(ptr++) = '-';
+			ptr += p.print( entry.magnitude, ptr );
+			*(ptr++) = '\n';
+		}
+		best = std::min( best, clock_type::now() - start_time );
+		length = ptr - out.data();
+	}
+	const double seconds = std::chrono::duration< double >( best ).count();
+	std::cout << "\t\t " << name << ": " 
+			<< seconds * 1e9 / entries.size() << " ns per value, " 
+			<< length / seconds / 1e6 << " MB/s" << std::endl;
+}
+
+int main( int argc, char* argv[] )
+{
+	using namespace ml::printers;
+	if ( argc < 2 ) {
+		std::cerr << "Usage: " << argv[ 0 ] << " <corpus file> [rounds]" << std::endl;
+		return 2;
+	}
+	const int rounds = argc > 2 ? std::max( 1, atoi( argv[ 2 ] ) ) : 5;
+	corpus c;
+	if ( ! read_corpus( argv[ 1 ], c ) ) {
+		std::cerr << "Can't read corpus '" << argv[ 1 ] << "'." << std::endl;
+		return 1;
+	}
+	std::cout << "Corpus '" << argv[ 1 ] << "': " << c.entries.size() 
+			<< " values from " << c.sites.size() << " call-sites." << std::endl;
+	// Values and their digit lengths, per call-site and per base
+	std::vector< size_t > site_counts( c.sites.size() );
+	std::map< short, std::vector< corpus_entry > > base_entries;
+	for ( const corpus_entry& entry : c.entries ) {
+		if ( (size_t)entry.site < site_counts.size() )
+			++site_counts[ entry.site ];
+		if ( TABLES_BASE_MIN <= entry.base && entry.base <= TABLES_BASE_MAX )
+			base_entries[ entry.base ].push_back( entry );
+	}
+	for ( size_t i = 0; i < c.sites.size(); ++i )
+		std::cout << "\t " << c.sites[ i ] << ": " << site_counts[ i ] 
+				<< " values" << std::endl;
+	for ( const auto& base_and_entries : base_entries ) {
+		const short base = base_and_entries.first;
+		const std::vector< corpus_entry >& entries = base_and_entries.second;
+		std::map< int, size_t > lengths;
+		char buf[ 64 + 7 ];
+		composed_printer< uint64_t > length_printer( base );
+		for ( const corpus_entry& entry : entries )
+			++lengths[ length_printer.print( entry.magnitude, buf ) ];
+		std::cout << "\t base=" << base << ", " << entries.size() 
+				<< " values, digit lengths:";
+		for ( const auto& length_and_count : lengths )
+			std::cout << " " << length_and_count.first << "(" 
+					<< length_and_count.second << ")";
+		std::cout << std::endl;
+		std::vector< char > out( entries.size() * (64 + 2) );
+		{
+			modulo_printer_2_digits< uint64_t > p( base );
+			replay( "modulo_printer_2_digits", p, entries, rounds, out );
+		}
+		if ( base <= LR_2_DIGITS_BASE_MAX ) {
+			lr_printer_2_digits< uint64_t > p( base );
+			replay( "lr_printer_2_digits", p, entries, rounds, out );
+		}
+		if ( base <= LR_2_DIGITS_BASE_MAX ) {
+			memoizing_printer< uint64_t > p( base );
+			replay( "memoizing_printer", p, entries, rounds, out );
+		}
+		{
+			lean_printer< uint64_t > p( base );
+			replay( "lean_printer", p, entries, rounds, out );
+		}
+		{
+			composed_printer< uint64_t, modulo_2_digits_engine > p( base );
+			replay( "composed_printer< modulo_2_digits >", p, entries, rounds, out );
+		}
+		{
+			composed_printer< uint64_t, lr_2_digits_engine > p( base );
+			replay( "composed_printer< lr_2_digits >", p, entries, rounds, out );
+		}
+		{
+			composed_printer< uint64_t, lr_k_digits_engine< 4 > > p( base );
+			replay( "composed_printer< lr_k_digits< 4 > >", p, entries, rounds, out );
+		}
+	}
+	return 0;
+}
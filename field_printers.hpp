@@ -0,0 +1,144 @@
+
+#ifndef ML__PRINTERS__FIELD_PRINTERS_HPP
+#define ML__PRINTERS__FIELD_PRINTERS_HPP
+
+#include <limits>
+#include <type_traits>
+#include <cassert>
+
+#include "lr_printer_2_digits.hpp"
+#include "printer_tables.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This class prints integers (possibly negative) in base 10, as fields of
+/// some textual record. Digits are produced by 'lr_printer_2_digits'.
+/// Nothing is appended after the printed characters.
+template< typename NumberType >
+class integer_field_printer
+{
+public:
+	typedef NumberType number_type;
+	typedef integer_field_printer< NumberType > this_type;
+
+	/// Type of absolute value of the printed numbers.
+	typedef typename std::make_unsigned< NumberType >::type magnitude_type;
+
+	/// Maximal count of characters printed for any number: all the digits
+	/// and the sign.
+	static constexpr int MAX_LENGTH
+			= std::numeric_limits< magnitude_type >::digits10 + 1 + 1;
+
+protected:
+	/// Printer of absolute values.
+	lr_printer_2_digits< magnitude_type > _printer;
+
+public:
+	/// Prints 'x' into 'out'.
+	/// Returns pointer past the last printed character.
+	char* print( number_type x, char* out ) const {
+		magnitude_type magnitude = (magnitude_type)x;
+		if ( x < 0 ) {
+			*(out++) = '-';
+			magnitude = (magnitude_type)0 - magnitude;
+		}
+		return _printer.print_digits( magnitude, out );
+	}
+
+	/// Returns count of characters, which printing of 'x' produces.
+	/// Count of digits is obtained by comparing with all powers of 10, 
+	/// without branches.
+	int length( number_type x ) const {
+		magnitude_type magnitude = (magnitude_type)x;
+		int result = 1;
+		if ( x < 0 ) {
+			++result;
+			magnitude = (magnitude_type)0 - magnitude;
+		}
+		const magnitude_type* powers = get_precomputed_powers< magnitude_type >( 10 );
+		const short powers_length = get_precomputed_powers_length< magnitude_type >( 10 );
+		for ( short k = 1; k < powers_length; ++k )
+			result += (int)(powers[ k ] <= magnitude);
+		return result;
+	}
+};
+
+
+/// This class prints fixed-point numbers in base 10, as fields of some
+/// textual record. Fixed-point number is given as an integer, with 'scale'
+/// last digits of which being its fractional part, so with scale=2 the
+/// integer -12345 is printed as "-123.45".
+/// Nothing is appended after the printed characters.
+template< typename NumberType >
+class fixed_point_field_printer
+{
+public:
+	typedef NumberType number_type;
+	typedef fixed_point_field_printer< NumberType > this_type;
+
+	/// Type of absolute value of the printed numbers.
+	typedef typename std::make_unsigned< NumberType >::type magnitude_type;
+
+	/// Maximal count of characters printed for any number: all the digits,
+	/// possible leading zero, the sign and the decimal point.
+	static constexpr int MAX_LENGTH
+			= std::numeric_limits< magnitude_type >::digits10 + 1 + 3;
+
+	/// Maximal supported scale.
+	/// Fractional part is printed together with a leading '1', so it must
+	/// fit in 'magnitude_type'.
+	static constexpr short SCALE_MAX
+			= std::numeric_limits< magnitude_type >::digits10 - 1;
+
+protected:
+	/// Count of fractional digits.
+	short _scale;
+
+	/// 10 in power of '_scale'.
+	magnitude_type _scale_power;
+
+	/// Printer of absolute values.
+	lr_printer_2_digits< magnitude_type > _printer;
+
+public:
+	/// Constructor with scale specification.
+	explicit fixed_point_field_printer( short scale_ = 0 )
+		{ set_scale( scale_ ); }
+
+	/// Setter / getter for the scale.
+	void set_scale( short scale_ )
+		{ assert( 0 <= scale_ && scale_ <= SCALE_MAX );
+		  _scale = scale_;
+		  _scale_power = get_precomputed_powers< magnitude_type >( 10 )[ scale_ ]; }
+	short get_scale() const
+		{ return _scale; }
+
+	/// Prints 'x' into 'out'.
+	/// Returns pointer past the last printed character.
+	char* print( number_type x, char* out ) const {
+		magnitude_type magnitude = (magnitude_type)x;
+		if ( x < 0 ) {
+			*(out++) = '-';
+			magnitude = (magnitude_type)0 - magnitude;
+		}
+		if ( _scale == 0 )
+			return _printer.print_digits( magnitude, out );
+		const magnitude_type integer_part = magnitude / _scale_power;
+		const magnitude_type fractional_part = magnitude - integer_part * _scale_power;
+		out = _printer.print_digits( integer_part, out );
+		// Fractional part is printed with a leading '1', in order to have
+		// leading zeros, and then that '1' is replaced by the point
+		char* point = out;
+		out = _printer.print_digits( _scale_power + fractional_part, out );
+		*point = '.';
+		return out;
+	}
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__FIELD_PRINTERS_HPP
@@ -0,0 +1,204 @@
+
+#ifndef ML__PRINTERS__HEX_PRINTER_HPP
+#define ML__PRINTERS__HEX_PRINTER_HPP
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <cassert>
+
+#if defined( __SSSE3__ ) || defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+
+#include "printer_tables.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This class prints byte arrays (digests, identifiers) as hex strings, and
+/// 16-byte UUIDs in their canonical form "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx".
+/// As other printers, it uses an alphabet, so upper-case or any custom hex
+/// digits can be used.
+/// When compiled for SSSE3 (or AVX2), every 16 (or 32) bytes are split into
+/// nibbles, which are translated to alphabet characters by a single 'pshufb'
+/// (the alphabet being the lookup table), and dashes of UUIDs are inserted
+/// by shuffles too. Otherwise pairs of characters are taken from a table
+/// of all 256 bytes.
+class hex_printer
+{
+public:
+	typedef hex_printer this_type;
+
+	/// Length of a printed UUID.
+	static constexpr int UUID_LENGTH = 36;
+
+protected:
+	/// Hex digits count.
+	static constexpr short BASE = 16;
+
+	/// All the digits, used to print given bytes.
+	alignas( 16 ) char _alphabet[ BASE ];
+
+	/// Texts of all bytes: 2 characters for each one.
+	char _alphabet_sqr[ 2 * BASE * BASE ];
+
+protected:
+	/// Prints 'length' bytes from 'bytes' into 'out' by pairs of characters.
+	/// Returns pointer past the last printed character.
+	char* print_bytes_by_pairs( const uint8_t* bytes, size_t length, char* out ) const {
+		for ( const uint8_t* end = bytes + length; bytes != end; ++bytes, out += 2 )
+			memcpy( out, _alphabet_sqr + 2 * (*bytes), 2 );
+		return out;
+	}
+
+#if defined( __SSSE3__ ) || defined( __AVX2__ )
+	/// Translates 16 bytes into 32 characters: 'first' gets characters of
+	/// bytes [0, 8), and 'second' of bytes [8, 16).
+	void translate_16( __m128i bytes, __m128i& first, __m128i& second ) const {
+		const __m128i alphabet = _mm_load_si128( (const __m128i*)_alphabet );
+		const __m128i low_mask = _mm_set1_epi8( 0x0f );
+		const __m128i high_nibbles = _mm_and_si128( _mm_srli_epi16( bytes, 4 ), low_mask );
+		const __m128i low_nibbles = _mm_and_si128( bytes, low_mask );
+		const __m128i high_chars = _mm_shuffle_epi8( alphabet, high_nibbles );
+		const __m128i low_chars = _mm_shuffle_epi8( alphabet, low_nibbles );
+		first = _mm_unpacklo_epi8( high_chars, low_chars );
+		second = _mm_unpackhi_epi8( high_chars, low_chars );
+	}
+#endif
+
+#if defined( __AVX2__ )
+	/// Translates 32 bytes into 64 characters, written at 'out'.
+	void print_32( const uint8_t* bytes, char* out ) const {
+		const __m256i alphabet = _mm256_broadcastsi128_si256(
+				_mm_load_si128( (const __m128i*)_alphabet ) );
+		const __m256i low_mask = _mm256_set1_epi8( 0x0f );
+		const __m256i data = _mm256_loadu_si256( (const __m256i*)bytes );
+		const __m256i high_nibbles = _mm256_and_si256( _mm256_srli_epi16( data, 4 ), low_mask );
+		const __m256i low_nibbles = _mm256_and_si256( data, low_mask );
+		const __m256i high_chars = _mm256_shuffle_epi8( alphabet, high_nibbles );
+		const __m256i low_chars = _mm256_shuffle_epi8( alphabet, low_nibbles );
+		// Unpacking works inside 128-bit lanes, so the halves are reordered
+		const __m256i lows = _mm256_unpacklo_epi8( high_chars, low_chars );
+		const __m256i highs = _mm256_unpackhi_epi8( high_chars, low_chars );
+		_mm256_storeu_si256( (__m256i*)out, _mm256_permute2x128_si256( lows, highs, 0x20 ) );
+		_mm256_storeu_si256( (__m256i*)(out + 32), _mm256_permute2x128_si256( lows, highs, 0x31 ) );
+	}
+#endif
+
+	/// Assuming that we already have proper content in '_alphabet', calulates
+	/// and stores content of '_alphabet_sqr'.
+	void calculate_alphabet_sqr() {
+		int L = 0;  // Current length of '_alphabet_sqr'
+		for ( short i = 0; i < BASE; ++i ) {
+			for ( short j = 0; j < BASE; ++j ) {
+				_alphabet_sqr[ L++ ] = _alphabet[ i ];
+				_alphabet_sqr[ L++ ] = _alphabet[ j ];
+			}
+		}
+		assert( L == 2*BASE*BASE );
+	}
+
+public:
+	/// Constructor with default (lower-case) alphabet.
+	hex_printer()
+		{ setup_default_alphabet(); }
+
+	/// Constructor with alphabet specification.
+	explicit hex_printer( const std::string& alphabet_ )
+		{ set_alphabet( alphabet_ ); }
+
+	/// Setter / getter for the alphabet.
+	void set_alphabet( const std::string& alphabet_ )
+		{ assert( alphabet_.length() == (size_t)BASE );
+		  memcpy( _alphabet, alphabet_.data(), BASE );
+		  calculate_alphabet_sqr(); }
+	const auto& get_alphabet() const
+		{ return _alphabet; }
+
+	/// Sets up default alphabet: decimal digits, then lower-case (or
+	/// upper-case) letters.
+	void setup_default_alphabet( bool upper_case = false ) {
+		memcpy( _alphabet, DEFAULT_ALPHABET, BASE );
+		if ( upper_case )
+			for ( char& ch : _alphabet )
+				if ( 'a' <= ch && ch <= 'z' )
+					ch = (char)(ch - 'a' + 'A');
+		calculate_alphabet_sqr();
+	}
+
+	/// Prints 'length' bytes from 'bytes' into buffer 'buf' (2 characters
+	/// per byte), and appends null-character.
+	/// Returns number of characters printed (null-character not included).
+	int print( const uint8_t* bytes, size_t length, char* buf ) const {
+		char* out = buf;
+		const uint8_t* const end = bytes + length;
+#if defined( __AVX2__ )
+		for ( ; end - bytes >= 32; bytes += 32, out += 64 )
+			print_32( bytes, out );
+#endif
+#if defined( __SSSE3__ ) || defined( __AVX2__ )
+		for ( ; end - bytes >= 16; bytes += 16, out += 32 ) {
+			__m128i first, second;
+			translate_16( _mm_loadu_si128( (const __m128i*)bytes ), first, second );
+			_mm_storeu_si128( (__m128i*)out, first );
+			_mm_storeu_si128( (__m128i*)(out + 16), second );
+		}
+#endif
+		out = print_bytes_by_pairs( bytes, (size_t)(end - bytes), out );
+		*out = '\0';
+		return (int)(out - buf);
+	}
+
+	/// Prints UUID, given as 16 bytes, into buffer 'buf' (of at least
+	/// 'UUID_LENGTH' + 1 characters), and appends null-character.
+	/// Returns number of characters printed (null-character not included).
+	int print_uuid( const uint8_t* bytes, char* buf ) const {
+#if defined( __SSSE3__ ) || defined( __AVX2__ )
+		// Characters of the 1st and 2nd halves (A and B) are placed by
+		// shuffles, dashes are inserted by OR with constants (shuffle
+		// indexes with the highest bit set produce zeros)
+		__m128i a, b;
+		translate_16( _mm_loadu_si128( (const __m128i*)bytes ), a, b );
+		const char Z = (char)0x80;  // Produces zero
+		const char D = '-';
+		// [0, 16): A[0..7] - A[8..11] - A[12..13]
+		const __m128i out_0 = _mm_or_si128(
+				_mm_shuffle_epi8( a, _mm_setr_epi8( 0, 1, 2, 3, 4, 5, 6, 7, Z, 8, 9, 10, 11, Z, 12, 13 ) ),
+				_mm_setr_epi8( 0, 0, 0, 0, 0, 0, 0, 0, D, 0, 0, 0, 0, D, 0, 0 ) );
+		// [16, 32): A[14..15] - B[0..3] - B[4..11]
+		const __m128i out_16 = _mm_or_si128( _mm_or_si128(
+				_mm_shuffle_epi8( a, _mm_setr_epi8( 14, 15, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z, Z ) ),
+				_mm_shuffle_epi8( b, _mm_setr_epi8( Z, Z, Z, 0, 1, 2, 3, Z, 4, 5, 6, 7, 8, 9, 10, 11 ) ) ),
+				_mm_setr_epi8( 0, 0, D, 0, 0, 0, 0, D, 0, 0, 0, 0, 0, 0, 0, 0 ) );
+		// [20, 36): B[1..3] - B[4..15] (overlaps with the previous part)
+		const __m128i out_20 = _mm_or_si128(
+				_mm_shuffle_epi8( b, _mm_setr_epi8( 1, 2, 3, Z, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 ) ),
+				_mm_setr_epi8( 0, 0, 0, D, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 ) );
+		_mm_storeu_si128( (__m128i*)buf, out_0 );
+		_mm_storeu_si128( (__m128i*)(buf + 16), out_16 );
+		_mm_storeu_si128( (__m128i*)(buf + 20), out_20 );
+#else
+		char* out = buf;
+		out = print_bytes_by_pairs( bytes, 4, out );
+		*(out++) = '-';
+		out = print_bytes_by_pairs( bytes + 4, 2, out );
+		*(out++) = '-';
+		out = print_bytes_by_pairs( bytes + 6, 2, out );
+		*(out++) = '-';
+		out = print_bytes_by_pairs( bytes + 8, 2, out );
+		*(out++) = '-';
+		out = print_bytes_by_pairs( bytes + 10, 6, out );
+#endif
+		buf[ UUID_LENGTH ] = '\0';
+		return UUID_LENGTH;
+	}
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__HEX_PRINTER_HPP
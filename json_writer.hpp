@@ -0,0 +1,257 @@
+
+#ifndef ML__PRINTERS__JSON_WRITER_HPP
+#define ML__PRINTERS__JSON_WRITER_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <cstring>
+#include <cstddef>
+#include <cassert>
+
+#include "field_printers.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This class writes JSON text in a streaming manner (without building
+/// any document in memory), into its growable buffer.
+/// Integers are printed by 'lr_printer_2_digits' directly into the buffer.
+/// Keys, which are used repeatedly, can be registered once: they are
+/// escaped at registration and stored together with their quotes, colon
+/// and the preceding comma, so writing them later is a single copy.
+class json_writer
+{
+public:
+	typedef json_writer this_type;
+
+	/// Identifier of a registered key.
+	typedef size_t key_id;
+
+protected:
+	/// The buffer, holding the text.
+	std::vector< char > _buffer;
+
+	/// Length of the text in '_buffer'.
+	size_t _length = 0;
+
+	/// Tells if next element of the current container must be preceded by
+	/// a comma (i.e. some element was already written there).
+	bool _needs_comma = false;
+
+	/// Values of '_needs_comma' for all enclosing containers.
+	std::vector< bool > _scopes;
+
+	/// Registered keys, each one in form ',"key":'.
+	std::vector< std::string > _keys;
+
+	/// Printers of integers.
+	integer_field_printer< long long > _signed_printer;
+	integer_field_printer< unsigned long long > _unsigned_printer;
+
+	/// Printer of fixed-point numbers.
+	fixed_point_field_printer< long long > _fixed_point_printer;
+
+protected:
+	/// Makes sure that buffer has at least 'length' free characters.
+	/// Returns pointer to where next characters must be written.
+	char* reserve( size_t length ) {
+		if ( _buffer.size() - _length < length )
+			_buffer.resize( std::max( _buffer.size() * 2, _length + length ) );
+		return _buffer.data() + _length;
+	}
+
+	/// Marks the text up to 'ptr' as written.
+	void commit( char* ptr )
+		{ _length = (size_t)(ptr - _buffer.data());
+		  assert( _length <= _buffer.size() ); }
+
+	/// Writes comma, if the next element requires it.
+	/// Returns pointer past the written characters.
+	char* print_comma( char* ptr ) {
+		*ptr = ',';
+		ptr += (int)_needs_comma;  // Without branching
+		_needs_comma = true;
+		return ptr;
+	}
+
+	/// Returns maximal length of 'str' after escaping (with quotes).
+	static size_t escaped_length_max( size_t length )
+		{ return 6 * length + 2; }
+
+	/// Prints 'str' (of 'length' characters) escaped, with quotes.
+	/// Returns pointer past the last printed character.
+	static char* print_escaped( const char* str, size_t length, char* out ) {
+		static const char HEX_DIGITS[] = "0123456789abcdef";
+		*(out++) = '"';
+		for ( const char* end = str + length; str != end; ++str ) {
+			const unsigned char ch = (unsigned char)*str;
+			if ( ch >= 0x20 && ch != '"' && ch != '\\' ) {
+				*(out++) = (char)ch;
+				continue;
+			}
+			*(out++) = '\\';
+			switch ( ch ) {
+				case '"':  *(out++) = '"'; break;
+				case '\\': *(out++) = '\\'; break;
+				case '\b': *(out++) = 'b'; break;
+				case '\f': *(out++) = 'f'; break;
+				case '\n': *(out++) = 'n'; break;
+				case '\r': *(out++) = 'r'; break;
+				case '\t': *(out++) = 't'; break;
+				default:
+					memcpy( out, "u00", 3 );
+					out[ 3 ] = HEX_DIGITS[ ch >> 4 ];
+					out[ 4 ] = HEX_DIGITS[ ch & 0xf ];
+					out += 5;
+			}
+		}
+		*(out++) = '"';
+		return out;
+	}
+
+	/// Opens a container with 'bracket'.
+	void begin_container( char bracket ) {
+		char* ptr = print_comma( reserve( 2 ) );
+		*(ptr++) = bracket;
+		commit( ptr );
+		_scopes.push_back( _needs_comma );
+		_needs_comma = false;
+	}
+
+	/// Closes the current container with 'bracket'.
+	void end_container( char bracket ) {
+		assert( ! _scopes.empty() );
+		char* ptr = reserve( 1 );
+		*(ptr++) = bracket;
+		commit( ptr );
+		_needs_comma = _scopes.back();
+		_scopes.pop_back();
+	}
+
+public:
+	/// Constructor with specification of initial capacity of the buffer.
+	explicit json_writer( size_t capacity_ = 4 * 1024 )
+		: _buffer( capacity_ )
+		{}
+
+	/// Registers 'name' as a key, which will be used repeatedly.
+	/// Returns its identifier.
+	key_id add_key( const std::string& name ) {
+		std::vector< char > escaped( escaped_length_max( name.length() ) + 2 );
+		escaped[ 0 ] = ',';
+		char* end = print_escaped( name.data(), name.length(), escaped.data() + 1 );
+		*(end++) = ':';
+		_keys.emplace_back( escaped.data(), end );
+		return _keys.size() - 1;
+	}
+
+	/// Writes beginning and end of an object.
+	void begin_object()
+		{ begin_container( '{' ); }
+	void end_object()
+		{ end_container( '}' ); }
+
+	/// Writes beginning and end of an array.
+	void begin_array()
+		{ begin_container( '[' ); }
+	void end_array()
+		{ end_container( ']' ); }
+
+	/// Writes a registered key.
+	void key( key_id id ) {
+		assert( id < _keys.size() );
+		const std::string& k = _keys[ id ];
+		// Skip the comma, if not needed
+		const size_t skip = (size_t)! _needs_comma;
+		char* ptr = reserve( k.length() );
+		memcpy( ptr, k.data() + skip, k.length() - skip );
+		commit( ptr + k.length() - skip );
+		_needs_comma = false;  // Value follows
+	}
+
+	/// Writes a key, which is not registered.
+	void key( const std::string& name ) {
+		char* ptr = print_comma( reserve( escaped_length_max( name.length() ) + 2 ) );
+		ptr = print_escaped( name.data(), name.length(), ptr );
+		*(ptr++) = ':';
+		commit( ptr );
+		_needs_comma = false;  // Value follows
+	}
+
+	/// Writes an integer value.
+	template< typename NumberType >
+	typename std::enable_if< std::is_integral< NumberType >::value
+			&& ! std::is_same< NumberType, bool >::value >::type
+	value( NumberType x ) {
+		char* ptr = print_comma( reserve(
+				1 + integer_field_printer< long long >::MAX_LENGTH ) );
+		if ( std::is_signed< NumberType >::value )
+			ptr = _signed_printer.print( (long long)x, ptr );
+		else
+			ptr = _unsigned_printer.print( (unsigned long long)x, ptr );
+		commit( ptr );
+	}
+
+	/// Writes a fixed-point value: 'x' with 'scale' last digits being the
+	/// fractional part.
+	void value_fixed_point( long long x, short scale ) {
+		char* ptr = print_comma( reserve(
+				1 + fixed_point_field_printer< long long >::MAX_LENGTH ) );
+		_fixed_point_printer.set_scale( scale );
+		commit( _fixed_point_printer.print( x, ptr ) );
+	}
+
+	/// Writes a string value.
+	void value( const char* str, size_t length ) {
+		char* ptr = print_comma( reserve( 1 + escaped_length_max( length ) ) );
+		commit( print_escaped( str, length, ptr ) );
+	}
+	void value( const std::string& str )
+		{ value( str.data(), str.length() ); }
+	void value( const char* str )
+		{ value( str, strlen( str ) ); }
+
+	/// Writes a boolean value.
+	void value( bool x ) {
+		char* ptr = print_comma( reserve( 1 + 5 ) );
+		memcpy( ptr, x ? "true" : "false", 5 );
+		commit( ptr + (x ? 4 : 5) );
+	}
+
+	/// Writes null value.
+	void value_null() {
+		char* ptr = print_comma( reserve( 1 + 4 ) );
+		memcpy( ptr, "null", 4 );
+		commit( ptr + 4 );
+	}
+
+	/// Writes a registered key, together with its value.
+	template< typename ValueType >
+	void member( key_id id, const ValueType& x )
+		{ key( id );
+		  value( x ); }
+
+	/// Accessors to the written text.
+	const char* data() const
+		{ return _buffer.data(); }
+	size_t size() const
+		{ return _length; }
+	std::string str() const
+		{ return std::string( _buffer.data(), _length ); }
+
+	/// Clears the written text, so the writer can be used for another
+	/// document. Registered keys and the buffer are kept.
+	void clear()
+		{ _length = 0;
+		  _needs_comma = false;
+		  _scopes.clear(); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__JSON_WRITER_HPP
@@ -0,0 +1,252 @@
+
+#ifndef ML__PRINTERS__LEAN_PRINTER_HPP
+#define ML__PRINTERS__LEAN_PRINTER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+#include "printer_tables.hpp"
+
+/// Attributes, which keep a function out of line ('NOINLINE'), and also
+/// move it away from the frequently executed code ('COLD').
+#if defined( __GNUC__ ) || defined( __clang__ )
+#	define ML_PRINTERS_NOINLINE __attribute__(( noinline ))
+#	define ML_PRINTERS_COLD __attribute__(( noinline, cold ))
+#elif defined( _MSC_VER )
+#	define ML_PRINTERS_NOINLINE __declspec( noinline )
+#	define ML_PRINTERS_COLD __declspec( noinline )
+#else
+#	define ML_PRINTERS_NOINLINE
+#	define ML_PRINTERS_COLD
+#endif
+
+namespace ml {
+namespace printers {
+
+
+/// This is the core of 'lean_printer': all integer types of up to 64 bits
+/// are printed by this single non-template class, as 64-bit unsigned
+/// numbers.
+/// Only the printing loop is hot, and is kept small: digits are obtained
+/// from left to right, 2 at a time, by the precomputed powers (so there are
+/// no lazily grown tables), with 32-bit divisions for numbers which fit in
+/// 32 bits. Everything else (switching the base or the
+/// alphabet, output to files and streams) is out of line and marked cold.
+/// The functions are defined in the header, but are never inlined, so there
+/// is a single copy of them in the whole program.
+class lean_printer_core
+{
+public:
+	typedef lean_printer_core this_type;
+
+	/// Maximal count of digits of a printed number (in base 2).
+	static constexpr int DIGITS_MAX = 64;
+
+protected:
+	/// Powers of the base, which fit in 64 bits.
+	const uint64_t* _powers = nullptr;
+
+	/// Count of '_powers'.
+	short _powers_length = 0;
+
+	/// Powers of the base, which fit in 32 bits, and their count.
+	const uint32_t* _powers_32 = nullptr;
+	short _powers_32_length = 0;
+
+	/// The base.
+	short _base = -1;
+
+	/// Pairs of characters of the alphabet. For the default alphabet it
+	/// points to the precomputed table, otherwise to '_custom_pairs'.
+	const char* _pairs = nullptr;
+
+	/// Pairs of characters of the custom alphabet, shared among copies of
+	/// the printer.
+	std::shared_ptr< const std::vector< char > > _custom_pairs;
+
+	/// The custom alphabet, empty for the default one.
+	std::string _alphabet;
+
+protected:
+	/// Prints 'x' by 'powers' of the base, from left to right, 2 digits at
+	/// a time.
+	/// Returns pointer past the last printed digit.
+	template< typename UnsignedType >
+	char* print_by_powers( UnsignedType x, const UnsignedType* powers,
+			short powers_length, char* out ) const {
+		// Index of power of the current digit
+		short k = 1;
+		while ( k < powers_length && powers[ k ] <= x )
+			++k;
+		--k;
+		if ( (k & 1) == 0 ) {
+			// Odd count: the first digit alone
+			const unsigned digit = (unsigned)(x / powers[ k ]);
+			*(out++) = _pairs[ 2 * digit + 1 ];
+			x -= digit * powers[ k ];
+			--k;
+		}
+		for ( ; k > 0; k -= 2 ) {
+			const unsigned pair = (unsigned)(x / powers[ k - 1 ]);
+			memcpy( out, _pairs + 2 * pair, 2 );
+			out += 2;
+			x -= pair * powers[ k - 1 ];
+		}
+		return out;
+	}
+
+	/// Calculates '_pairs' for the current base and alphabet.
+	ML_PRINTERS_COLD void calculate_pairs() {
+		if ( _alphabet.empty() ) {
+			_pairs = get_precomputed_default_pairs< char >( _base );
+			_custom_pairs.reset();
+			return;
+		}
+		assert( (size_t)_base <= _alphabet.length() );
+		auto pairs = std::make_shared< std::vector< char > >( 2 * _base * _base );
+		char* ptr = pairs->data();
+		for ( short i = 0; i < _base; ++i ) {
+			for ( short j = 0; j < _base; ++j ) {
+				*(ptr++) = _alphabet[ i ];
+				*(ptr++) = _alphabet[ j ];
+			}
+		}
+		_pairs = pairs->data();
+		_custom_pairs = std::move( pairs );
+	}
+
+public:
+	/// Constructor with base specification.
+	explicit lean_printer_core( short base_ = 10 )
+		{ set_base( base_ ); }
+
+	/// Constructor with base & alphabet specification.
+	lean_printer_core( short base_, const std::string& alphabet_ )
+		: _alphabet( alphabet_ )
+		{ set_base( base_ ); }
+
+	/// Setter / getter for the base.
+	ML_PRINTERS_COLD void set_base( short base_ ) {
+		assert( TABLES_BASE_MIN <= base_ && base_ <= TABLES_BASE_MAX );
+		_base = base_;
+		_powers = get_precomputed_powers< uint64_t >( base_ );
+		_powers_length = get_precomputed_powers_length< uint64_t >( base_ );
+		_powers_32 = get_precomputed_powers< uint32_t >( base_ );
+		_powers_32_length = get_precomputed_powers_length< uint32_t >( base_ );
+		calculate_pairs();
+	}
+	short get_base() const
+		{ return _base; }
+
+	/// Setter / getter for the alphabet.
+	ML_PRINTERS_COLD void set_alphabet( const std::string& alphabet_ ) {
+		_alphabet = alphabet_;
+		calculate_pairs();
+	}
+	std::string get_alphabet() const
+		{ return _alphabet.empty()
+				? std::string( DEFAULT_ALPHABET, TABLES_BASE_MAX )
+				: _alphabet; }
+
+	/// Sets up default alphabet.
+	ML_PRINTERS_COLD void setup_default_alphabet() {
+		_alphabet.clear();
+		calculate_pairs();
+	}
+
+	/// Prints 'x' into buffer 'buf', without appending null-character.
+	/// Returns pointer past the last printed digit.
+	ML_PRINTERS_NOINLINE char* print_digits( uint64_t x, char* out ) const {
+		// Numbers, which fit in 32 bits, are printed by cheaper divisions
+		if ( x <= std::numeric_limits< uint32_t >::max() )
+			return print_by_powers( (uint32_t)x, _powers_32, _powers_32_length, out );
+		return print_by_powers( x, _powers, _powers_length, out );
+	}
+
+	/// Prints 'x' into specified file.
+	/// Returns number of digits printed.
+	ML_PRINTERS_COLD int print_to_file( uint64_t x, FILE* file ) const {
+		char buffer[ DIGITS_MAX ];
+		const char* buffer_end = print_digits( x, buffer );
+		fwrite( buffer, 1, buffer_end - buffer, file );
+		return (int)(buffer_end - buffer);
+	}
+
+	/// Prints 'x' into output stream 'ostr'.
+	ML_PRINTERS_COLD std::ostream& print_to_stream(
+			uint64_t x, std::ostream& ostr ) const {
+		char buffer[ DIGITS_MAX ];
+		const char* buffer_end = print_digits( x, buffer );
+		return ostr.write( buffer, buffer_end - buffer );
+	}
+};
+
+
+/// This printer outputs natural numbers with least possible code: every
+/// instantiation only converts the number to 64 bits, and calls the common
+/// 'lean_printer_core'. So it fits the programs, which print many integer
+/// types, and where misses of the instruction cache cost more than the
+/// printing itself.
+template< typename NumberType >
+class lean_printer : public lean_printer_core
+{
+public:
+	typedef NumberType number_type;
+	typedef lean_printer< NumberType > this_type;
+	typedef lean_printer_core core_type;
+
+	static_assert( std::is_integral< NumberType >::value
+			&& sizeof( NumberType ) <= sizeof( uint64_t ),
+			"Lean printer accepts integer types of up to 64 bits." );
+
+public:
+	/// Constructor with base specification.
+	explicit lean_printer( short base_ = 10 )
+		: core_type( base_ )
+		{}
+
+	/// Constructor with base & alphabet specification.
+	lean_printer( short base_, const std::string& alphabet_ )
+		: core_type( base_, alphabet_ )
+		{}
+
+	/// Prints integer 'x' into buffer 'buf', and appends null-character.
+	/// Returns number of digits printed (null-character not included).
+	int print( const number_type& x, char* buf ) const
+		{ assert( x >= 0 );
+		  char* buf_end = core_type::print_digits( (uint64_t)x, buf );
+		  *buf_end = '\0';
+		  return (int)(buf_end - buf); }
+
+	/// Prints integer 'x' into buffer 'buf', without appending null-character.
+	/// Returns pointer past the last printed digit.
+	char* print_digits( const number_type& x, char* buf ) const
+		{ assert( x >= 0 );
+		  return core_type::print_digits( (uint64_t)x, buf ); }
+
+	/// Prints integer 'x' into specified file, without appending any other
+	/// character.
+	/// Returns number of digits printed.
+	int print( const number_type& x, FILE* file ) const
+		{ assert( x >= 0 );
+		  return print_to_file( (uint64_t)x, file ); }
+
+	/// Prints integer 'x' into output stream 'ostr'.
+	std::ostream& print( const number_type& x, std::ostream& ostr ) const
+		{ assert( x >= 0 );
+		  return print_to_stream( (uint64_t)x, ostr ); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__LEAN_PRINTER_HPP
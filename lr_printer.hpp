@@ -5,8 +5,16 @@
 #include <string>
 #include <ostream>
 #include <cstdio>
+#include <cstddef>
 #include <cstring>
 #include <cassert>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+#include "printer_tables.hpp"
+#include "printer_stats_hooks.hpp"
+#include "value_capture_hooks.hpp"
 
 namespace ml {
 namespace printers {
@@ -17,12 +25,14 @@ namespace printers {
 /// 1'000'000, then 100'000, then 10'000, and so on.
 /// In order to get what remains for next iteration, instead of calculating 
 /// remainder it does subtraction.
-template< typename NumberType >
+template< typename NumberType, typename CharT = char >
 class lr_printer
 {
 public:
 	typedef NumberType number_type;
-	typedef lr_printer< NumberType > this_type;
+	typedef CharT char_type;
+	typedef std::basic_string< CharT > string_type;
+	typedef lr_printer< NumberType, CharT > this_type;
 
 protected:
 	/// The maximal value of base, which can be used during print
@@ -36,7 +46,7 @@ protected:
 	short _base = -1;
 
 	/// All the digits, used to print given numbers.
-	char _alphabet[ MAX_BASE ];
+	char_type _alphabet[ MAX_BASE ];
 
 	/// Some integer types are bounded while some others are not.
 	/// This class calculates (amoung other) all powers of 'base', which fit 
@@ -54,16 +64,31 @@ protected:
 	/// Actual length of '_powers[]' array.
 	mutable short _powers_length = 0;
 
+	/// Type of '_powers'. For bounded integer types it is a pointer to the 
+	/// precomputed table of the current base, so switching the base costs 
+	/// nothing. For other types it is an array, filled incrementally.
+	typedef typename std::conditional< 
+			has_precomputed_powers< number_type >::value, 
+			const number_type*, 
+			number_type[ MAX_DIGITS ] >::type powers_type;
+
 	/// Powers of the base, which will be used when calculating remainder 
 	/// of the division (without actually calling remainder).
-	mutable number_type _powers[ MAX_DIGITS ];
+	mutable powers_type _powers;
 
 	/// The buffer to hold the digits, before sending them to output 
 	/// stream or output file (in order to not send them digit by digit 
 	/// there).
-	mutable char _buffer[ MAX_DIGITS ];
+	mutable char_type _buffer[ MAX_DIGITS ];
 
 protected:
+	/// Copies 'alphabet_' into '_alphabet'.
+	void copy_alphabet( const string_type& alphabet_ ) {
+		assert( alphabet_.length() <= (size_t)MAX_BASE );
+		std::char_traits< char_type >::copy( _alphabet, alphabet_.data(), 
+				std::min( alphabet_.length(), (size_t)MAX_BASE ) );
+	}
+
 	/// This is the base printing routine.
 	template< typename OutIt >
 	OutIt print_to_out_iter( number_type num, OutIt out ) const {
@@ -73,7 +98,7 @@ protected:
 			return out;
 		}
 		// Start with the most significant digit
-		number_type* power_ptr = get_max_power_ptr( num );
+		const number_type* power_ptr = get_max_power_ptr( num );
 		short digit;
 		for ( ; power_ptr >= _powers; --power_ptr ) {
 			// Find left-most digit
@@ -90,6 +115,110 @@ protected:
 	}
 
 public:
+	/// Input iterator over digits of a number, which are obtained from left 
+	/// to right on demand (one division per step), without being written 
+	/// anywhere. So a consumer which needs only a few leading digits doesn't 
+	/// pay for the rest.
+	/// The iterator refers to data of the printer, so it remains valid until 
+	/// the printer is changed or destroyed.
+	class digit_iterator
+	{
+	public:
+		typedef std::input_iterator_tag iterator_category;
+		typedef short value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const short* pointer;
+		typedef short reference;
+
+	protected:
+		/// Power of the base, corresponding to the current digit.
+		const number_type* _power_ptr = nullptr;
+
+		/// Remaining part of the number, starting from the current digit.
+		number_type _rest = 0;
+
+		/// Value of the current digit.
+		short _digit = 0;
+
+		/// Count of remaining digits, including the current one.
+		short _remaining = 0;
+
+		/// Alphabet of the printer.
+		const char_type* _alphabet = nullptr;
+
+		/// Calculates value of the current digit.
+		void obtain_digit()
+			{ _digit = (short)(_rest / *_power_ptr); }
+
+	public:
+		/// Constructs the past-the-end iterator.
+		digit_iterator() = default;
+
+		/// Constructs iterator at the first of 'count' digits of 'num', 
+		/// where 'power_ptr' points to power of the first digit.
+		digit_iterator( const number_type& num, const number_type* power_ptr, 
+				short count, const char_type* alphabet )
+			: _power_ptr( power_ptr ), _rest( num ), 
+			  _remaining( count ), _alphabet( alphabet )
+			{ obtain_digit(); }
+
+		/// Value of the current digit.
+		short operator*() const
+			{ assert( _remaining > 0 );
+			  return _digit; }
+
+		/// Character of the current digit.
+		char_type character() const
+			{ assert( _remaining > 0 );
+			  return _alphabet[ _digit ]; }
+
+		/// Count of remaining digits, including the current one.
+		short remaining() const
+			{ return _remaining; }
+
+		/// Advances to the next digit.
+		digit_iterator& operator++() {
+			assert( _remaining > 0 );
+			_rest -= _digit * (*_power_ptr);
+			if ( --_remaining > 0 ) {
+				--_power_ptr;
+				obtain_digit();
+			}
+			return *this;
+		}
+		digit_iterator operator++( int )
+			{ digit_iterator result = *this;
+			  ++(*this);
+			  return result; }
+
+		/// Iterators are compared by count of remaining digits, so any 
+		/// exhausted iterator is equal to the past-the-end one.
+		bool operator==( const digit_iterator& other ) const
+			{ return _remaining == other._remaining; }
+		bool operator!=( const digit_iterator& other ) const
+			{ return _remaining != other._remaining; }
+	};
+
+	/// Range of digits of a number, from left to right.
+	class digit_range
+	{
+	protected:
+		digit_iterator _begin;
+
+	public:
+		explicit digit_range( const digit_iterator& begin_ )
+			: _begin( begin_ )
+			{}
+
+		digit_iterator begin() const
+			{ return _begin; }
+		digit_iterator end() const
+			{ return digit_iterator(); }
+
+		/// Count of the digits.
+		short size() const
+			{ return _begin.remaining(); }
+	};
 
 	/// Constructor with base specification.
 	explicit lr_printer( short base_ = 10 )
@@ -97,9 +226,9 @@ public:
 		  setup_default_alphabet(); }
 
 	/// Constructor with base & alphabet specification.
-	lr_printer( short base_, const std::string& alphabet_ )
+	lr_printer( short base_, const string_type& alphabet_ )
 		{ set_base( base_ );
-		  strcpy_s( _alphabet, alphabet_.c_str() ); }
+		  copy_alphabet( alphabet_ ); }
 
 	/// Setter / getter for the base.
 	void set_base( short base_ )
@@ -113,54 +242,103 @@ public:
 		{ return _powers; }
 
 	/// Setter / getter for the alphabet.
-	void set_alphabet( const std::string& alphabet_ )
-		{ strcpy_s( _alphabet, alphabet_.c_str() ); }
+	void set_alphabet( const string_type& alphabet_ )
+		{ copy_alphabet( alphabet_ ); }
 	const auto& get_alphabet() const
 		{ return _alphabet; }
 
 	/// Sets up default alphabet (at first decimal digits, then lower alpha 
 	/// characters).
+	/// All the characters are placed, so the alphabet remains valid after 
+	/// switching to any other base.
 	void setup_default_alphabet() {
 		assert( _base <= 10 + 26 );  // Maximal possible characters, 
 		                             // that can be used
-		short length = 0;
-		// Attach digits
-		for ( char ch = '0'; ch <= '9' 
-				&& length < _base; 
-				++ch, ++length )
-			_alphabet[ length ] = ch;
-		// Attach letters
-		for ( char ch = 'a'; ch <= 'z'
-				&& length < _base; 
-				++ch, ++length )
-			_alphabet[ length ] = ch;
+		for ( short i = 0; i < MAX_BASE; ++i )
+			_alphabet[ i ] = (char_type)DEFAULT_ALPHABET[ i ];
 	}
 
 	/// Prints integer 'x' into buffer 'buf', and appends null-character.
 	/// Returns number of digits printed (null-character not included).
-	int print( const number_type& x, char* buf ) const
-		{ char* buf_end = print_to_out_iter( x, buf );
+	int print( const number_type& x, char_type* buf ) const
+		{ ML_PRINTERS_STATS_SCOPE( stats, "lr_printer", SINK_BUFFER );
+		  ML_PRINTERS_CAPTURE_AT( "lr_printer", x, _base );
+		  char_type* buf_end = print_to_out_iter( x, buf );
 		  *buf_end = '\0';
+		  ML_PRINTERS_STATS_DIGITS( stats, buf_end - buf );
 		  return (int)(buf_end - buf); }
 
+	/// Prints integer 'x' into buffer 'buf', without appending null-character.
+	/// Returns pointer past the last printed digit.
+	char_type* print_digits( const number_type& x, char_type* buf ) const
+		{ ML_PRINTERS_STATS_SCOPE( stats, "lr_printer", SINK_BUFFER );
+		  ML_PRINTERS_CAPTURE_AT( "lr_printer", x, _base );
+		  char_type* buf_end = print_to_out_iter( x, buf );
+		  ML_PRINTERS_STATS_DIGITS( stats, buf_end - buf );
+		  return buf_end; }
+
+	/// Returns range of digits of integer 'x', which are obtained lazily, 
+	/// from left to right.
+	digit_range digits( const number_type& x ) const {
+		if ( x == 0 )
+			return digit_range( digit_iterator( x, _powers, 1, _alphabet ) );
+		const number_type* power_ptr = get_max_power_ptr( x );
+		return digit_range( digit_iterator( 
+				x, power_ptr, (short)(power_ptr - _powers + 1), _alphabet ) );
+	}
+
+	/// Checks if text of integer 'x' starts with 'prefix', obtaining no 
+	/// more digits than needed for that.
+	bool has_prefix( const number_type& x, const string_type& prefix ) const {
+		const digit_range range = digits( x );
+		if ( (size_t)range.size() < prefix.length() )
+			return false;
+		digit_iterator it = range.begin();
+		for ( const char_type ch : prefix ) {
+			if ( it.character() != ch )
+				return false;
+			++it;
+		}
+		return true;
+	}
+
 	/// Prints integer 'x' into specified file, without appending any other 
-	/// character.
+	/// character. Characters are written as they are (not converted to 
+	/// multi-byte ones).
 	/// Returns number of digits printed.
 	int print( const number_type& x, FILE* file ) const
-		{ char* buf_end = print_to_out_iter( x, _buffer );
-		  *buf_end = '\0';
-		  fprintf( file, "%s", _buffer );
+		{ ML_PRINTERS_STATS_SCOPE( stats, "lr_printer", SINK_FILE );
+		  ML_PRINTERS_CAPTURE_AT( "lr_printer", x, _base );
+		  char_type* buf_end = print_to_out_iter( x, _buffer );
+		  ML_PRINTERS_STATS_DIGITS( stats, buf_end - _buffer );
+		  fwrite( _buffer, sizeof( char_type ), buf_end - _buffer, file );
 		  return (int)(buf_end - _buffer); }
 
 	/// Prints integer 'x' into output stream 'ostr'.
-	std::ostream& print( const number_type& x, std::ostream& ostr ) const
-		{ char* buf_end = print_to_out_iter( x, _buffer );
+	std::basic_ostream< char_type >& print( const number_type& x, 
+			std::basic_ostream< char_type >& ostr ) const
+		{ ML_PRINTERS_STATS_SCOPE( stats, "lr_printer", SINK_STREAM );
+		  ML_PRINTERS_CAPTURE_AT( "lr_printer", x, _base );
+		  char_type* buf_end = print_to_out_iter( x, _buffer );
+		  ML_PRINTERS_STATS_DIGITS( stats, buf_end - _buffer );
 		  return ostr.write( _buffer, (int)(buf_end - _buffer) ); }
 
 protected:
 	/// Initialized starting state of helper data, so it can be already 
 	/// used for printing (not so large) numbers.
-	void init_helper_data() const {
+	void init_helper_data() const
+		{ init_helper_data( has_precomputed_powers< number_type >() ); }
+
+	/// For bounded integer types, just takes the precomputed table.
+	void init_helper_data( std::true_type ) const {
+		assert( TABLES_BASE_MIN <= _base && _base <= TABLES_BASE_MAX );
+		_powers = get_precomputed_powers< number_type >( _base );
+		_powers_length = get_precomputed_powers_length< number_type >( _base );
+		_reached_max_power = true;
+	}
+
+	/// For other types, calculates first few powers.
+	void init_helper_data( std::false_type ) const {
 		const int DATA_INIT_LENGTH = 4;
 		// Calculate first 'row's
 		_powers_length = 1;
@@ -175,13 +353,21 @@ protected:
 	/// Generally this method will be called when the number which is 
 	/// received for printing is larger than values of current helper data.
 	/// Returns if successfully appened. Failer might happen only on overflow.
-	bool append_helper_data() const {
+	bool append_helper_data() const
+		{ return append_helper_data( has_precomputed_powers< number_type >() ); }
+
+	/// Precomputed table already contains all the powers.
+	bool append_helper_data( std::true_type ) const
+		{ return false; }
+
+	bool append_helper_data( std::false_type ) const {
 		// Append powers
 		const number_type new_power = _powers[ _powers_length - 1 ] * _base;
 		if ( new_power / _base != _powers[ _powers_length - 1 ] )
 			return false;  // Overflow. No more powers can be appended.
 		_powers[ _powers_length ] = new_power;
 		++_powers_length;
+		ML_PRINTERS_STATS_GROWTH( "lr_printer" );
 		return true;
 	}
 
@@ -189,7 +375,7 @@ protected:
 	/// the helper data should be addressed, in order to print given number.
 	/// Generally that will be equal to count of digits of the given 
 	/// number minus 1.
-	number_type* get_max_power_ptr( const number_type& num ) const {
+	const number_type* get_max_power_ptr( const number_type& num ) const {
 		if ( _reached_max_power ) {
 			if ( _powers[ _powers_length - 1 ] <= num )  // 'num' is a max-digit number
 				return _powers + _powers_length - 1;
@@ -204,7 +390,7 @@ protected:
 			}
 		}
 		// Find proper power incrementally
-		number_type* power_ptr = _powers;
+		const number_type* power_ptr = _powers;
 		while ( *power_ptr <= num )
 			++power_ptr;
 		--power_ptr;  // one less
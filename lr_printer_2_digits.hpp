@@ -7,6 +7,14 @@
 #include <cstring>
 #include <cstdio>
 #include <cassert>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+#include "printer_tables.hpp"
+#include "printer_stats_hooks.hpp"
+#include "value_capture_hooks.hpp"
 
 namespace ml {
 namespace printers {
@@ -17,12 +25,14 @@ namespace printers {
 /// let's say: 1'000'000, then 10'000, then 100, and so on.
 /// In order to get what remains for next iteration, instead of calculating 
 /// remainder it does subtraction.
-template< typename NumberType >
+template< typename NumberType, typename CharT = char >
 class lr_printer_2_digits
 {
 public:
 	typedef NumberType number_type;
-	typedef lr_printer_2_digits< NumberType > this_type;
+	typedef CharT char_type;
+	typedef std::basic_string< CharT > string_type;
+	typedef lr_printer_2_digits< NumberType, CharT > this_type;
 
 protected:
 	/// The base, by which numbers will be printed.
@@ -37,13 +47,24 @@ protected:
 	static constexpr short BASE_MAX = 10 + 6 + 1;
 
 	/// All the digits, used to print given numbers.
-	char _alphabet[ BASE_MAX ];
+	char_type _alphabet[ BASE_MAX ];
+
+	/// Indicates if the default alphabet is used, for which pairs of 
+	/// characters are precomputed.
+	bool _default_alphabet = true;
 
 	/// This string contains 2*|N|*|N| characters, each pair corresponding 
 	/// to pair of alphabet characters, all ordered by alphanumerical.
 	/// This is where from pairs of digits will be selected for printing, 
 	/// instead of selecting digits individually.
-	char _alphabet_sqr[ BASE_MAX * BASE_MAX * 2 ];
+	/// For the default alphabet it points to the precomputed table, otherwise 
+	/// to '_custom_alphabet_sqr'.
+	const char_type* _alphabet_sqr = nullptr;
+
+	/// Pairs of characters of the custom alphabet.
+	/// The table is never modified after being calculated, so it can be 
+	/// shared among copies of the printer.
+	std::shared_ptr< const std::vector< char_type > > _custom_alphabet_sqr;
 
 	/// Some integer types are bounded while some others are not.
 	/// This class calculates (amoung other) all powers of 'base', which fit 
@@ -65,16 +86,42 @@ protected:
 	/// How many values of '_powers[]' array are currently calculated.
 	mutable short _powers_length;
 
+	/// Type of '_powers'. For bounded integer types it is a pointer to the 
+	/// precomputed table of the current base, so switching the base costs 
+	/// nothing. For other types it is an array, filled incrementally.
+	typedef typename std::conditional< 
+			has_precomputed_powers< number_type >::value, 
+			const number_type*, 
+			number_type[ DIGITS_MAX ] >::type powers_type;
+
 	/// Powers of the base, which will be used when calculating remainder 
 	/// of the division (without actually calling remainder).
-	mutable number_type _powers[ DIGITS_MAX ];
+	mutable powers_type _powers;
 
 	/// The buffer to hold the digits, before sending them to output 
 	/// stream or output file (in order to not send them digit by digit 
 	/// there).
-	mutable char _buffer[ DIGITS_MAX ];
+	mutable char_type _buffer[ DIGITS_MAX ];
 
 protected:
+	/// Copies 'alphabet_' into '_alphabet'.
+	void copy_alphabet( const string_type& alphabet_ ) {
+		assert( alphabet_.length() <= (size_t)BASE_MAX );
+		std::char_traits< char_type >::copy( _alphabet, alphabet_.data(), 
+				std::min( alphabet_.length(), (size_t)BASE_MAX ) );
+	}
+
+	/// Prints pair of characters, starting at 'pair'.
+	/// For pointers it is a single move (of 2, 4 or 8 bytes, depending on 
+	/// width of the characters).
+	static void print_pair( const char_type* pair, char_type*& out )
+		{ memcpy( out, pair, 2 * sizeof( char_type ) );
+		  out += 2; }
+	template< typename OutIt >
+	static void print_pair( const char_type* pair, OutIt& out )
+		{ *(out++) = pair[ 0 ];
+		  *(out++) = pair[ 1 ]; }
+
 	/// This is the base printing routine.
 	template< typename OutIt >
 	OutIt print_to_out_iter( number_type num, OutIt out ) const {
@@ -84,8 +131,8 @@ protected:
 			return out;
 		}
 		// Start with the most significant digit
-		number_type* power_ptr = get_max_power_ptr( num );
-		number_type* power_ptr_lim = _powers + 1;
+		const number_type* power_ptr = get_max_power_ptr( num );
+		const number_type* power_ptr_lim = _powers + 1;
 		short digits_2;
 		for ( ; power_ptr >= power_ptr_lim; power_ptr -= 2 ) {
 			// Find 2 left-most digits
@@ -93,8 +140,7 @@ protected:
 			assert( 0 <= digits_2 );
 			assert( digits_2 < _base_sqr );
 			// Print them
-			*(out++) = _alphabet_sqr[ digits_2 * 2 ];
-			*(out++) = _alphabet_sqr[ (digits_2 * 2) + 1 ];
+			print_pair( _alphabet_sqr + digits_2 * 2, out );
 			// Advance to remaining part
 			num -= digits_2 * (*power_ptr);
 		}
@@ -103,15 +149,14 @@ protected:
 		if ( power_ptr == _powers ) {
 			// 2 digits remain
 			assert( 0 <= num );
-			assert( num < _base_sqr );
+			assert( num < (number_type)_base_sqr );
 			// Print them
-			*(out++) = _alphabet_sqr[ num * 2 ];
-			*(out++) = _alphabet_sqr[ (num * 2) + 1 ];
+			print_pair( _alphabet_sqr + num * 2, out );
 		}
 		else if ( power_ptr == _powers - 1 ) {
 			// 1 digit remains
 			assert( 0 <= num );
-			assert( num < _base );
+			assert( num < (number_type)_base );
 			// Print it
 			*(out++) = _alphabet[ num ];
 		}
@@ -126,11 +171,13 @@ public:
 		  setup_default_alphabet(); }
 
 	/// Constructor with base & alphabet specification.
-	lr_printer_2_digits( short base_, const std::string& alphabet_ )
+	lr_printer_2_digits( short base_, const string_type& alphabet_ )
 		{ set_base( base_ );
 		  set_alphabet( alphabet_ ); }
 
 	/// Setter / getter for the base.
+	/// With the default alphabet and a bounded integer type this only 
+	/// switches pointers to the precomputed tables.
 	void set_base( short base_ )
 		{ _base = base_;
 		  _base_sqr = base_ * base_;
@@ -144,73 +191,107 @@ public:
 		{ return _powers; }
 
 	/// Setter / getter for the alphabet.
-	void set_alphabet( const std::string& alphabet_ )
-		{ strcpy_s( _alphabet, alphabet_.c_str() );
+	void set_alphabet( const string_type& alphabet_ )
+		{ copy_alphabet( alphabet_ );
+		  _default_alphabet = false;
 		  calculate_alphabet_sqr(); }
 	const auto& get_alphabet() const
 		{ return _alphabet; }
 
 	/// Sets up default alphabet (at first decimal digits, then lower alpha 
 	/// characters).
+	/// All the characters are placed, so the alphabet remains valid after 
+	/// switching to any other base.
 	void setup_default_alphabet() {
 		assert( _base <= 10 + 6 );  // Maximal possible characters, 
 		                            // that can be used
-		int L = 0;  // Current length of '_alphabet'
-		// Attach digits
-		for ( char ch = '0'; ch <= '9' 
-				&& L < _base; 
-				++ch )
-			_alphabet[ L++ ] = ch;
-		// Attach letters
-		for ( char ch = 'a'; ch <= 'z'
-				&& L < _base; 
-				++ch )
-			_alphabet[ L++ ] = ch;
-		assert( L == _base );
+		for ( short i = 0; i < BASE_MAX; ++i )
+			_alphabet[ i ] = (char_type)DEFAULT_ALPHABET[ i ];
+		_default_alphabet = true;
 		// Make further computations
 		calculate_alphabet_sqr();
 	}
 
 	/// Prints integer 'x' into buffer 'buf', and appends null-character.
 	/// Returns number of digits printed (null-character not included).
-	int print( const number_type& x, char* buf ) const
-		{ char* buf_end = print_to_out_iter( x, buf );
+	int print( const number_type& x, char_type* buf ) const
+		{ ML_PRINTERS_STATS_SCOPE( stats, "lr_printer_2_digits", SINK_BUFFER );
+		  ML_PRINTERS_CAPTURE_AT( "lr_printer_2_digits", x, _base );
+		  char_type* buf_end = print_to_out_iter( x, buf );
 		  *buf_end = '\0';
+		  ML_PRINTERS_STATS_DIGITS( stats, buf_end - buf );
 		  return (int)(buf_end - buf); }
 
+	/// Prints integer 'x' into buffer 'buf', without appending null-character.
+	/// Returns pointer past the last printed digit.
+	char_type* print_digits( const number_type& x, char_type* buf ) const
+		{ ML_PRINTERS_STATS_SCOPE( stats, "lr_printer_2_digits", SINK_BUFFER );
+		  ML_PRINTERS_CAPTURE_AT( "lr_printer_2_digits", x, _base );
+		  char_type* buf_end = print_to_out_iter( x, buf );
+		  ML_PRINTERS_STATS_DIGITS( stats, buf_end - buf );
+		  return buf_end; }
+
 	/// Prints integer 'x' into specified file, without appending any other 
-	/// character.
+	/// character. Characters are written as they are (not converted to 
+	/// multi-byte ones).
 	/// Returns number of digits printed.
 	int print( const number_type& x, FILE* file ) const
-		{ char* buf_end = print_to_out_iter( x, _buffer );
-		  *buf_end = '\0';
-		  fprintf( file, "%s", _buffer );
+		{ ML_PRINTERS_STATS_SCOPE( stats, "lr_printer_2_digits", SINK_FILE );
+		  ML_PRINTERS_CAPTURE_AT( "lr_printer_2_digits", x, _base );
+		  char_type* buf_end = print_to_out_iter( x, _buffer );
+		  ML_PRINTERS_STATS_DIGITS( stats, buf_end - _buffer );
+		  fwrite( _buffer, sizeof( char_type ), buf_end - _buffer, file );
 		  return (int)(buf_end - _buffer); }
 
 	/// Prints integer 'x' into output stream 'ostr'.
-	std::ostream& print( const number_type& x, std::ostream& ostr ) const
-		{ char* buf_end = print_to_out_iter( x, _buffer );
+	std::basic_ostream< char_type >& print( const number_type& x, 
+			std::basic_ostream< char_type >& ostr ) const
+		{ ML_PRINTERS_STATS_SCOPE( stats, "lr_printer_2_digits", SINK_STREAM );
+		  ML_PRINTERS_CAPTURE_AT( "lr_printer_2_digits", x, _base );
+		  char_type* buf_end = print_to_out_iter( x, _buffer );
+		  ML_PRINTERS_STATS_DIGITS( stats, buf_end - _buffer );
 		  return ostr.write( _buffer, (buf_end - _buffer) ); }
 
 protected:
 	/// Assuming that we already have proper content in '_alphabet', calulates 
 	/// and stores content of '_alphabet_sqr'.
+	/// For the default alphabet just takes the precomputed table.
 	void calculate_alphabet_sqr() {
-		// Clear
-		int L = 0;  // Current length of '_alphabet_sqr'
+		if ( _default_alphabet ) {
+			assert( TABLES_BASE_MIN <= _base && _base <= TABLES_BASE_MAX );
+			_alphabet_sqr = get_precomputed_default_pairs< char_type >( _base );
+			return;
+		}
+		std::shared_ptr< std::vector< char_type > > alphabet_sqr 
+				= std::make_shared< std::vector< char_type > >( 2*_base*_base );
 		// Fill
+		int L = 0;  // Current length of '_alphabet_sqr'
 		for ( short i = 0; i < _base; ++i ) {
 			for ( short j = 0; j < _base; ++j ) {
-				_alphabet_sqr[ L++ ] = _alphabet[ i ];
-				_alphabet_sqr[ L++ ] = _alphabet[ j ];
+				(*alphabet_sqr)[ L++ ] = _alphabet[ i ];
+				(*alphabet_sqr)[ L++ ] = _alphabet[ j ];
 			}
 		}
 		assert( L == 2*_base*_base );
+		_alphabet_sqr = alphabet_sqr->data();
+		_custom_alphabet_sqr = std::move( alphabet_sqr );
 	}
 
 	/// Initialized starting state of helper data, so it can be already 
 	/// used for printing (not so large) numbers.
-	void init_helper_data() const {
+	void init_helper_data() const
+		{ init_helper_data( has_precomputed_powers< number_type >() ); }
+
+	/// For bounded integer types, just takes the precomputed table.
+	void init_helper_data( std::true_type ) const {
+		assert( TABLES_BASE_MIN <= _base && _base <= TABLES_BASE_MAX );
+		_powers = get_precomputed_powers< number_type >( _base );
+		_powers_length = get_precomputed_powers_length< number_type >( _base );
+		_reached_max_power = true;
+	}
+
+	/// For other types, calculates first few powers.
+	void init_helper_data( std::false_type ) const {
 		const int DATA_INIT_LENGTH = 4;
 		// Calculate first 'row's
 		//   powers
@@ -226,13 +307,21 @@ protected:
 	/// Generally this method will be called when the number which is 
 	/// received for printing is larger than values of current helper data.
 	/// Returns if successfully appened. Failer might happen only on overflow.
-	bool append_helper_data() const {
+	bool append_helper_data() const
+		{ return append_helper_data( has_precomputed_powers< number_type >() ); }
+
+	/// Precomputed table already contains all the powers.
+	bool append_helper_data( std::true_type ) const
+		{ return false; }
+
+	bool append_helper_data( std::false_type ) const {
 		// Append powers
 		const number_type new_power = _powers[ _powers_length - 1 ] * _base;
 		if ( new_power / _base != _powers[ _powers_length - 1 ] )
 			return false;
 		_powers[ _powers_length ] = new_power;
 		++_powers_length;
+		ML_PRINTERS_STATS_GROWTH( "lr_printer_2_digits" );
 		return true;
 	}
 
@@ -240,7 +329,7 @@ protected:
 	/// the helper data should be addressed, in order to print given number.
 	/// Generally that will be equal to count of digits of the given 
 	/// number minus 2.
-	number_type* get_max_power_ptr( const number_type& num ) const {
+	const number_type* get_max_power_ptr( const number_type& num ) const {
 		if ( _reached_max_power ) {
 			if ( _powers[ _powers_length - 2 ] <= num ) {
 				// 'num' is either a max-digit value, or 1-less digit value
@@ -263,7 +352,7 @@ protected:
 			}
 		}
 		// Find proper power
-		number_type* power_ptr = _powers;
+		const number_type* power_ptr = _powers;
 		//   go with double steps
 		while ( *power_ptr <= num )
 			power_ptr += 2;
@@ -0,0 +1,232 @@
+
+#ifndef ML__PRINTERS__NATURAL_PRINTER_LEFT_TO_RIGHT_BATCH_C_STYLE_HPP
+#define ML__PRINTERS__NATURAL_PRINTER_LEFT_TO_RIGHT_BATCH_C_STYLE_HPP
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <cstddef>
+#include <cassert>
+
+#include "lr_printer_2_digits.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This printer converts whole arrays of natural numbers at once.
+/// When lengths of printed numbers are randomly mixed, loops of the regular
+/// printers run different count of iterations for every number, and so
+/// they are constantly mispredicted. Here at first all the numbers are
+/// classified by their count of digits (with a single pass over the
+/// powers table), and then every group of equal-length numbers is printed
+/// by a fully unrolled routine, generated exactly for that length. Results
+/// are placed in the output in the original order of the numbers.
+template< typename NumberType >
+class lr_printer_batch : public lr_printer_2_digits< NumberType >
+{
+public:
+	typedef NumberType number_type;
+	typedef lr_printer_batch< NumberType > this_type;
+	typedef lr_printer_2_digits< NumberType > base_type;
+
+protected:
+	/// Maximal count of digits, for which an unrolled routine is generated.
+	/// This covers 64-bit numbers in base 10. Longer numbers (which can
+	/// appear only for smaller bases) are printed by the regular routine.
+	static constexpr short UNROLLED_DIGITS_MAX = 20;
+
+	/// Type of the routine, which prints a group of equal-length numbers.
+	typedef void (this_type::*group_printer_type)(
+			const number_type*, const size_t*, const size_t*,
+			const size_t*, char* ) const;
+
+	/// Count of digits of every number in the current batch.
+	mutable std::vector< short > _lengths;
+
+	/// Position in the output, where every number of the current batch
+	/// should be printed.
+	mutable std::vector< size_t > _offsets;
+
+	/// Indexes of numbers of the current batch, grouped by count of digits.
+	mutable std::vector< size_t > _order;
+
+protected:
+	/// Returns 'k'-th power of 10, calculated at compile time.
+	/// Powers, which don't fit in 'number_type', are never used, as there 
+	/// are no numbers that long.
+	static constexpr number_type decimal_power( int k ) {
+		unsigned long long result = 1;
+		for ( ; k > 0; --k )
+			result *= 10;
+		return (number_type)result;
+	}
+
+	/// Prints 'L' digits of 'num' (which must have exactly that many
+	/// digits, possibly with leading zeros) into 'out'.
+	/// If 'Decimal' is set, base is known to be 10, so divisions are done by 
+	/// compile-time constants.
+	/// Returns pointer past the last printed digit.
+	template< bool Decimal, int L >
+	char* print_fixed_length( number_type num, char* out,
+			std::integral_constant< int, L > ) const {
+		const number_type power = Decimal 
+				? std::integral_constant< number_type, decimal_power( L - 2 ) >::value
+				: this->_powers[ L - 2 ];
+		// Find 2 left-most digits
+		const short digits_2 = (short)(num / power);
+		assert( 0 <= digits_2 );
+		assert( digits_2 < this->_base_sqr );
+		// Print them
+		out[ 0 ] = this->_alphabet_sqr[ digits_2 * 2 ];
+		out[ 1 ] = this->_alphabet_sqr[ (digits_2 * 2) + 1 ];
+		// Advance to remaining part
+		num -= digits_2 * power;
+		return print_fixed_length< Decimal >( num, out + 2,
+				std::integral_constant< int, L - 2 >() );
+	}
+
+	template< bool Decimal >
+	char* print_fixed_length( number_type num, char* out,
+			std::integral_constant< int, 2 > ) const {
+		assert( 0 <= num );
+		assert( num < (number_type)this->_base_sqr );
+		out[ 0 ] = this->_alphabet_sqr[ num * 2 ];
+		out[ 1 ] = this->_alphabet_sqr[ (num * 2) + 1 ];
+		return out + 2;
+	}
+
+	template< bool Decimal >
+	char* print_fixed_length( number_type num, char* out,
+			std::integral_constant< int, 1 > ) const {
+		assert( 0 <= num );
+		assert( num < (number_type)this->_base );
+		out[ 0 ] = this->_alphabet[ num ];
+		return out + 1;
+	}
+
+	/// Prints all numbers of the group [first, last) (given by their indexes),
+	/// each of which has exactly 'L' digits.
+	template< bool Decimal, int L >
+	void print_group( const number_type* nums,
+			const size_t* first, const size_t* last,
+			const size_t* offsets, char* buf ) const {
+		for ( ; first != last; ++first )
+			print_fixed_length< Decimal >( nums[ *first ], buf + offsets[ *first ],
+					std::integral_constant< int, L >() );
+	}
+
+	/// Prints all numbers of the group [first, last), which are too long to
+	/// have an unrolled routine.
+	void print_group_regular( const number_type* nums,
+			const size_t* first, const size_t* last,
+			const size_t* offsets, char* buf ) const {
+		for ( ; first != last; ++first )
+			this->print_to_out_iter( nums[ *first ], buf + offsets[ *first ] );
+	}
+
+	/// Returns the table of group printing routines, where routine at
+	/// index 'L' prints numbers with 'L' digits.
+	template< bool Decimal, int... Ls >
+	static const group_printer_type* get_group_printers(
+			std::integer_sequence< int, Ls... > ) {
+		static const group_printer_type printers[] = {
+				nullptr,  // There are no 0-digit numbers
+				&this_type::template print_group< Decimal, Ls + 1 >... };
+		return printers;
+	}
+	const group_printer_type* get_group_printers() const {
+		const auto lengths = std::make_integer_sequence< int, UNROLLED_DIGITS_MAX >();
+		return this->_base == 10
+				? get_group_printers< true >( lengths )
+				: get_group_printers< false >( lengths );
+	}
+
+	/// Makes sure that the powers table covers all numbers in 'nums'.
+	void prepare_powers( const number_type* nums, size_t count ) const {
+		if ( std::numeric_limits< number_type >::is_bounded ) {
+			this->get_max_power_ptr( std::numeric_limits< number_type >::max() );
+			return;
+		}
+		number_type max_num = 0;
+		for ( size_t i = 0; i < count; ++i )
+			if ( max_num < nums[ i ] )
+				max_num = nums[ i ];
+		this->get_max_power_ptr( max_num );
+	}
+
+public:
+	/// Constructor with base specification.
+	explicit lr_printer_batch( short base_ = 10 )
+		: base_type( base_ )
+		{}
+
+	/// Constructor with base & alphabet specification.
+	lr_printer_batch( short base_, const std::string& alphabet_ )
+		: base_type( base_, alphabet_ )
+		{}
+
+	using base_type::print;
+
+	/// Prints 'count' integers from 'nums' into buffer 'buf', each of them
+	/// followed by 'separator', keeping their original order. No
+	/// null-character is appended.
+	/// Returns number of characters printed.
+	size_t print( const number_type* nums, size_t count,
+			char* buf, char separator ) const {
+		prepare_powers( nums, count );
+		const number_type* powers = this->_powers;
+		const short powers_length = this->_powers_length;
+		// Classify by count of digits, and calculate output positions
+		_lengths.resize( count );
+		_offsets.resize( count );
+		size_t group_sizes[ base_type::DIGITS_MAX + 1 ] = {};
+		size_t total_length = 0;
+		for ( size_t i = 0; i < count; ++i ) {
+			short length = 1;
+			for ( short k = 1; k < powers_length; ++k )
+				length += (short)(powers[ k ] <= nums[ i ]);
+			_lengths[ i ] = length;
+			++group_sizes[ length ];
+			_offsets[ i ] = total_length;
+			total_length += length + 1;
+			buf[ total_length - 1 ] = separator;
+		}
+		// Group indexes by count of digits
+		size_t group_starts[ base_type::DIGITS_MAX + 2 ];
+		group_starts[ 0 ] = 0;
+		for ( short L = 0; L <= base_type::DIGITS_MAX; ++L )
+			group_starts[ L + 1 ] = group_starts[ L ] + group_sizes[ L ];
+		_order.resize( count );
+		{
+			size_t group_ends[ base_type::DIGITS_MAX + 1 ];
+			std::copy( group_starts, group_starts + base_type::DIGITS_MAX + 1,
+					group_ends );
+			for ( size_t i = 0; i < count; ++i )
+				_order[ group_ends[ _lengths[ i ] ]++ ] = i;
+		}
+		// Print every group
+		const group_printer_type* group_printers = get_group_printers();
+		const size_t* order = _order.data();
+		for ( short L = 1; L <= base_type::DIGITS_MAX; ++L ) {
+			if ( group_sizes[ L ] == 0 )
+				continue;
+			const size_t* first = order + group_starts[ L ];
+			const size_t* last = order + group_starts[ L + 1 ];
+			if ( L <= UNROLLED_DIGITS_MAX )
+				(this->*group_printers[ L ])( nums, first, last, _offsets.data(), buf );
+			else
+				print_group_regular( nums, first, last, _offsets.data(), buf );
+		}
+		return total_length;
+	}
+
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__NATURAL_PRINTER_LEFT_TO_RIGHT_BATCH_C_STYLE_HPP
@@ -0,0 +1,233 @@
+
+#ifndef ML__PRINTERS__NATURAL_PRINTER_LEFT_TO_RIGHT_TRANSLATED_C_STYLE_HPP
+#define ML__PRINTERS__NATURAL_PRINTER_LEFT_TO_RIGHT_TRANSLATED_C_STYLE_HPP
+
+#include <string>
+#include <ostream>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <cassert>
+
+#if defined( __SSSE3__ ) || defined( __AVX2__ )
+#include <immintrin.h>
+#endif
+
+#include "printer_tables.hpp"
+#include "lr_printer.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This class translates digits, printed with the default alphabet 
+/// ("0123456789abc...z"), into characters of a custom alphabet.
+/// When compiled for SSSE3, 16 digits are translated at once: their raw 
+/// values (0, 1, ... up to 35) are calculated in a register, the custom 
+/// alphabet is split into tables of 16 characters, every table is looked up 
+/// by a single 'pshufb', and only the results of the table which the digit 
+/// belongs to are kept. So for alphabets of up to 16 characters that is one 
+/// shuffle per 16 digits, and for up to 36 characters - 3 shuffles.
+class alphabet_translator
+{
+public:
+	typedef alphabet_translator this_type;
+
+	/// Size of '_symbols': maximal count of characters in the alphabet, 
+	/// rounded up to whole tables.
+	static constexpr int SYMBOLS_MAX = 48;
+
+	/// Count of digits, translated at once. Buffers, passed for translation, 
+	/// must have room for whole blocks.
+	static constexpr int BLOCK_SIZE = 16;
+
+protected:
+	/// Characters of the alphabet, by tables of 16.
+	alignas( 16 ) char _symbols[ SYMBOLS_MAX ];
+
+	/// Count of used tables.
+	int _tables_count = 0;
+
+public:
+	/// Sets the alphabet of 'length' characters.
+	void set_alphabet( const char* alphabet_, int length ) {
+		assert( 0 < length && length <= TABLES_BASE_MAX );
+		memset( _symbols, 0, SYMBOLS_MAX );
+		memcpy( _symbols, alphabet_, length );
+		_tables_count = (length + BLOCK_SIZE - 1) / BLOCK_SIZE;
+	}
+
+	/// Translates 'length' digits of the default alphabet in 'data' to 
+	/// characters of the custom alphabet, in place.
+	/// 'data' must have room for 'length', rounded up to 'BLOCK_SIZE'.
+	void translate( char* data, size_t length ) const {
+#if defined( __SSSE3__ ) || defined( __AVX2__ )
+		const __m128i high_mask = _mm_set1_epi8( (char)0xf0 );
+		for ( size_t i = 0; i < length; i += BLOCK_SIZE ) {
+			// Raw values: 'c - '0'' for decimal digits, 'c - 'a' + 10' for letters
+			const __m128i chars = _mm_loadu_si128( (const __m128i*)(data + i) );
+			const __m128i is_letter = _mm_cmpgt_epi8( chars, _mm_set1_epi8( '9' ) );
+			const __m128i digits = _mm_sub_epi8( _mm_sub_epi8( chars, _mm_set1_epi8( '0' ) ), 
+					_mm_and_si128( is_letter, _mm_set1_epi8( 'a' - '0' - 10 ) ) );
+			// Only lower 4 bits of the values are used by the shuffles
+			__m128i result = _mm_shuffle_epi8( 
+					_mm_load_si128( (const __m128i*)_symbols ), digits );
+			if ( _tables_count > 1 ) {
+				const __m128i table_ids = _mm_and_si128( digits, high_mask );
+				result = _mm_and_si128( result, 
+						_mm_cmpeq_epi8( table_ids, _mm_setzero_si128() ) );
+				for ( int t = 1; t < _tables_count; ++t ) {
+					const __m128i from_table = _mm_shuffle_epi8( 
+							_mm_load_si128( (const __m128i*)(_symbols + t * BLOCK_SIZE) ), 
+							digits );
+					const __m128i is_table = _mm_cmpeq_epi8( 
+							table_ids, _mm_set1_epi8( (char)(t * BLOCK_SIZE) ) );
+					result = _mm_or_si128( result, _mm_and_si128( from_table, is_table ) );
+				}
+			}
+			_mm_storeu_si128( (__m128i*)(data + i), result );
+		}
+#else
+		for ( size_t i = 0; i < length; ++i ) {
+			const char ch = data[ i ];
+			const int digit = ch <= '9' ? ch - '0' : ch - 'a' + 10;
+			assert( 0 <= digit && digit < SYMBOLS_MAX );
+			data[ i ] = _symbols[ digit ];
+		}
+#endif
+	}
+};
+
+
+/// This printer obtains digits from left to right, 2 at a time, taking 
+/// them from the precomputed table of pairs of the default alphabet (which 
+/// exists for all bases), and then translates all of them to the custom 
+/// alphabet at once, by 'alphabet_translator'.
+/// So custom alphabets don't need their own tables, and cost nearly the 
+/// same as the default one (also for bases above 16).
+template< typename NumberType >
+class lr_printer_translated : public lr_printer< NumberType >
+{
+public:
+	typedef NumberType number_type;
+	typedef lr_printer_translated< NumberType > this_type;
+	typedef lr_printer< NumberType > base_type;
+
+protected:
+	using base_type::MAX_DIGITS;
+	using base_type::_base;
+	using base_type::_alphabet;
+	using base_type::_powers;
+	using base_type::get_max_power_ptr;
+
+	/// Size of '_digits', rounded up to whole blocks of the translator.
+	static constexpr int DIGITS_BUFFER_SIZE = (MAX_DIGITS
+			+ alphabet_translator::BLOCK_SIZE - 1)
+			/ alphabet_translator::BLOCK_SIZE * alphabet_translator::BLOCK_SIZE;
+
+	/// The translator from the default alphabet to the current one.
+	alphabet_translator _translator;
+
+	/// Pairs of digits of the default alphabet, for the current base.
+	const char* _default_pairs = nullptr;
+
+	/// The buffer, where digits are obtained and translated. It is 
+	/// zero-filled, so its tail after the digits, which is translated with 
+	/// them as a whole block, is never indeterminate.
+	alignas( 16 ) mutable char _digits[ DIGITS_BUFFER_SIZE ] = {};
+
+protected:
+	/// Prints digits of 'num' into '_digits' by the default alphabet, and 
+	/// translates them to the current alphabet.
+	/// Returns count of the digits.
+	int print_to_digits( number_type num ) const {
+		char* out = _digits;
+		if ( num < _base )
+			*(out++) = _default_pairs[ 2 * (int)num + 1 ];
+		else {
+			const number_type* power_ptr = get_max_power_ptr( num );
+			for ( ; power_ptr > _powers; power_ptr -= 2 ) {
+				// Find 2 left-most digits
+				const int digits_2 = (int)(num / *(power_ptr - 1));
+				assert( 0 <= digits_2 && digits_2 < _base * _base );
+				memcpy( out, _default_pairs + 2 * digits_2, 2 );
+				out += 2;
+				num -= digits_2 * (*(power_ptr - 1));
+			}
+			// Print the last digit, if remains
+			if ( power_ptr == _powers ) {
+				assert( 0 <= num && num < _base );
+				*(out++) = _default_pairs[ 2 * (int)num + 1 ];
+			}
+		}
+		const int length = (int)(out - _digits);
+		_translator.translate( _digits, length );
+		return length;
+	}
+
+	/// Passes the current alphabet to the translator, and takes the pairs 
+	/// table of the current base.
+	void update_translator()
+		{ _translator.set_alphabet( _alphabet, _base );
+		  _default_pairs = get_precomputed_default_pairs< char >( _base ); }
+
+public:
+	/// Constructor with base specification.
+	explicit lr_printer_translated( short base_ = 10 )
+		: base_type( base_ )
+		{ update_translator(); }
+
+	/// Constructor with base & alphabet specification.
+	lr_printer_translated( short base_, const std::string& alphabet_ )
+		: base_type( base_, alphabet_ )
+		{ update_translator(); }
+
+	/// Setter for the base.
+	void set_base( short base_ )
+		{ base_type::set_base( base_ );
+		  update_translator(); }
+
+	/// Setter for the alphabet.
+	void set_alphabet( const std::string& alphabet_ )
+		{ base_type::set_alphabet( alphabet_ );
+		  update_translator(); }
+
+	/// Sets up default alphabet.
+	void setup_default_alphabet()
+		{ base_type::setup_default_alphabet();
+		  update_translator(); }
+
+	/// Prints integer 'x' into buffer 'buf', and appends null-character.
+	/// Returns number of digits printed (null-character not included).
+	int print( const number_type& x, char* buf ) const
+		{ const int length = print_to_digits( x );
+		  memcpy( buf, _digits, length );
+		  buf[ length ] = '\0';
+		  return length; }
+
+	/// Prints integer 'x' into buffer 'buf', without appending null-character.
+	/// Returns pointer past the last printed digit.
+	char* print_digits( const number_type& x, char* buf ) const
+		{ const int length = print_to_digits( x );
+		  memcpy( buf, _digits, length );
+		  return buf + length; }
+
+	/// Prints integer 'x' into specified file, without appending any other
+	/// character.
+	/// Returns number of digits printed.
+	int print( const number_type& x, FILE* file ) const
+		{ const int length = print_to_digits( x );
+		  fwrite( _digits, 1, length, file );
+		  return length; }
+
+	/// Prints integer 'x' into output stream 'ostr'.
+	std::ostream& print( const number_type& x, std::ostream& ostr ) const
+		{ const int length = print_to_digits( x );
+		  return ostr.write( _digits, length ); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__NATURAL_PRINTER_LEFT_TO_RIGHT_TRANSLATED_C_STYLE_HPP
@@ -0,0 +1,254 @@
+
+#ifndef ML__PRINTERS__NATURAL_PRINTER_LEFT_TO_RIGHT_UTF8_C_STYLE_HPP
+#define ML__PRINTERS__NATURAL_PRINTER_LEFT_TO_RIGHT_UTF8_C_STYLE_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <ostream>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+#include <cassert>
+
+#include "printer_tables.hpp"
+#include "lr_printer.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This printer outputs natural numbers with digits, which are multi-byte
+/// UTF-8 sequences (like Arabic-Indic, Devanagari or fullwidth digits),
+/// obtaining them from left to right, 2 at a time.
+/// Every digit, and every pair of digits, is pre-encoded into a table with
+/// fixed stride, so printing of a pair is a single 8-byte copy, followed by
+/// advancing the output by actual length of the pair. Digits of one alphabet
+/// may have different lengths.
+/// Because of the fixed-size copies, buffers passed for printing must have
+/// at least 'BUFFER_SIZE_MIN' bytes.
+template< typename NumberType >
+class lr_printer_utf8 : public lr_printer< NumberType >
+{
+public:
+	typedef NumberType number_type;
+	typedef lr_printer_utf8< NumberType > this_type;
+	typedef lr_printer< NumberType > base_type;
+
+protected:
+	using base_type::MAX_BASE;
+	using base_type::MAX_DIGITS;
+	using base_type::_base;
+	using base_type::_powers;
+	using base_type::get_max_power_ptr;
+
+public:
+	/// Maximal length of a UTF-8 encoded character.
+	static constexpr int CHAR_LENGTH_MAX = 4;
+
+	/// Stride of the table of digits.
+	static constexpr int DIGIT_STRIDE = CHAR_LENGTH_MAX;
+
+	/// Stride of the table of pairs of digits.
+	static constexpr int PAIR_STRIDE = 2 * CHAR_LENGTH_MAX;
+
+	/// Minimal size of buffers, passed for printing: the longest number,
+	/// and room for the last fixed-size copy.
+	static constexpr int BUFFER_SIZE_MIN = MAX_DIGITS * CHAR_LENGTH_MAX + PAIR_STRIDE;
+
+protected:
+	/// Pre-encoded digits and pairs of digits for the current base.
+	/// The tables are never modified after being calculated, so they can
+	/// be shared among copies of the printer.
+	struct digit_tables {
+		/// Every digit, padded to 'DIGIT_STRIDE' bytes.
+		std::vector< char > digits;
+
+		/// Length of every digit.
+		std::vector< unsigned char > digit_lengths;
+
+		/// Every pair of digits, padded to 'PAIR_STRIDE' bytes.
+		std::vector< char > pairs;
+
+		/// Length of every pair of digits.
+		std::vector< unsigned char > pair_lengths;
+	};
+
+	/// Encodings of all characters of the alphabet, one after another.
+	std::vector< std::string > _utf8_alphabet;
+
+	/// Tables for the current alphabet and base.
+	std::shared_ptr< const digit_tables > _tables;
+
+	/// Pointers to the content of '_tables', used during printing.
+	const char* _digits = nullptr;
+	const unsigned char* _digit_lengths = nullptr;
+	const char* _pairs = nullptr;
+	const unsigned char* _pair_lengths = nullptr;
+
+	/// The buffer to hold the text, before sending it to output stream or
+	/// output file.
+	mutable char _text_buffer[ BUFFER_SIZE_MIN ];
+
+protected:
+	/// Prints digit 'digit' at 'out'.
+	/// Returns pointer past the printed digit.
+	char* print_digit( int digit, char* out ) const
+		{ memcpy( out, _digits + DIGIT_STRIDE * digit, DIGIT_STRIDE );
+		  return out + _digit_lengths[ digit ]; }
+
+	/// This is the base printing routine.
+	/// Returns pointer past the last printed digit.
+	char* print_to( number_type num, char* out ) const {
+		if ( num < _base )
+			return print_digit( (int)num, out );
+		// Start with the most significant pair of digits
+		const number_type* power_ptr = get_max_power_ptr( num );
+		for ( ; power_ptr > _powers; power_ptr -= 2 ) {
+			const int digits_2 = (int)(num / *(power_ptr - 1));
+			assert( 0 <= digits_2 && digits_2 < _base * _base );
+			memcpy( out, _pairs + PAIR_STRIDE * digits_2, PAIR_STRIDE );
+			out += _pair_lengths[ digits_2 ];
+			num -= digits_2 * (*(power_ptr - 1));
+		}
+		// Print the last digit, if remains
+		if ( power_ptr == _powers ) {
+			assert( 0 <= num && num < _base );
+			out = print_digit( (int)num, out );
+		}
+		return out;
+	}
+
+	/// Calculates tables of digits and pairs for the current alphabet and
+	/// base.
+	void calculate_tables() {
+		assert( (size_t)_base <= _utf8_alphabet.size() );
+		auto tables = std::make_shared< digit_tables >();
+		tables->digits.resize( DIGIT_STRIDE * _base, 0 );
+		tables->digit_lengths.resize( _base );
+		tables->pairs.resize( PAIR_STRIDE * _base * _base, 0 );
+		tables->pair_lengths.resize( _base * _base );
+		for ( int i = 0; i < _base; ++i ) {
+			const std::string& first = _utf8_alphabet[ i ];
+			memcpy( &tables->digits[ DIGIT_STRIDE * i ], first.data(), first.length() );
+			tables->digit_lengths[ i ] = (unsigned char)first.length();
+			for ( int j = 0; j < _base; ++j ) {
+				const std::string& second = _utf8_alphabet[ j ];
+				char* pair = &tables->pairs[ PAIR_STRIDE * (i * _base + j) ];
+				memcpy( pair, first.data(), first.length() );
+				memcpy( pair + first.length(), second.data(), second.length() );
+				tables->pair_lengths[ i * _base + j ]
+						= (unsigned char)(first.length() + second.length());
+			}
+		}
+		_digits = tables->digits.data();
+		_digit_lengths = tables->digit_lengths.data();
+		_pairs = tables->pairs.data();
+		_pair_lengths = tables->pair_lengths.data();
+		_tables = std::move( tables );
+	}
+
+public:
+	/// Splits UTF-8 encoded 'text' into characters.
+	/// Returns false if 'text' is not a valid UTF-8 sequence.
+	static bool split_utf8( const std::string& text, std::vector< std::string >& chars ) {
+		chars.clear();
+		for ( size_t i = 0; i < text.length(); ) {
+			const unsigned char lead = (unsigned char)text[ i ];
+			const int length = lead < 0x80 ? 1
+					: (lead & 0xe0) == 0xc0 ? 2
+					: (lead & 0xf0) == 0xe0 ? 3
+					: (lead & 0xf8) == 0xf0 ? 4
+					: 0;
+			if ( length == 0 || i + length > text.length() )
+				return false;
+			for ( int k = 1; k < length; ++k )
+				if ( ((unsigned char)text[ i + k ] & 0xc0) != 0x80 )
+					return false;  // Not a continuation byte
+			chars.push_back( text.substr( i, length ) );
+			i += length;
+		}
+		return true;
+	}
+
+	/// Constructor with base specification. The default (ASCII) alphabet
+	/// is used.
+	explicit lr_printer_utf8( short base_ = 10 )
+		: base_type( base_ )
+		{ setup_default_alphabet(); }
+
+	/// Constructor with base & alphabet (UTF-8 encoded) specification.
+	/// If 'alphabet_' is not valid (see 'set_alphabet()'), the default
+	/// alphabet is used.
+	lr_printer_utf8( short base_, const std::string& alphabet_ )
+		: base_type( base_ )
+		{ if ( ! set_alphabet( alphabet_ ) )
+			  setup_default_alphabet(); }
+
+	/// Setter for the base.
+	/// Returns false (keeping the current base) if the current alphabet has
+	/// less characters than 'base_'.
+	bool set_base( short base_ ) {
+		if ( (size_t)base_ > _utf8_alphabet.size() )
+			return false;
+		base_type::set_base( base_ );
+		calculate_tables();
+		return true;
+	}
+
+	/// Setter / getter for the alphabet, given as a UTF-8 encoded string.
+	/// Returns false (keeping the current alphabet) if 'alphabet_' is not
+	/// valid UTF-8, or has less characters than the current base.
+	bool set_alphabet( const std::string& alphabet_ ) {
+		std::vector< std::string > chars;
+		if ( ! split_utf8( alphabet_, chars ) || chars.size() < (size_t)_base )
+			return false;
+		_utf8_alphabet = std::move( chars );
+		calculate_tables();
+		return true;
+	}
+	const std::vector< std::string >& get_alphabet() const
+		{ return _utf8_alphabet; }
+
+	/// Sets up default alphabet (at first decimal digits, then lower alpha
+	/// characters).
+	void setup_default_alphabet() {
+		_utf8_alphabet.clear();
+		for ( short i = 0; i < MAX_BASE; ++i )
+			_utf8_alphabet.push_back( std::string( 1, DEFAULT_ALPHABET[ i ] ) );
+		calculate_tables();
+	}
+
+	/// Prints integer 'x' into buffer 'buf' (of at least 'BUFFER_SIZE_MIN'
+	/// bytes), and appends null-character.
+	/// Returns number of bytes printed (null-character not included).
+	int print( const number_type& x, char* buf ) const
+		{ char* buf_end = print_to( x, buf );
+		  *buf_end = '\0';
+		  return (int)(buf_end - buf); }
+
+	/// Prints integer 'x' into buffer 'buf' (of at least 'BUFFER_SIZE_MIN'
+	/// bytes), without appending null-character.
+	/// Returns pointer past the last printed byte.
+	char* print_digits( const number_type& x, char* buf ) const
+		{ return print_to( x, buf ); }
+
+	/// Prints integer 'x' into specified file, without appending any other
+	/// character.
+	/// Returns number of bytes printed.
+	int print( const number_type& x, FILE* file ) const
+		{ char* buf_end = print_to( x, _text_buffer );
+		  fwrite( _text_buffer, 1, buf_end - _text_buffer, file );
+		  return (int)(buf_end - _text_buffer); }
+
+	/// Prints integer 'x' into output stream 'ostr'.
+	std::ostream& print( const number_type& x, std::ostream& ostr ) const
+		{ char* buf_end = print_to( x, _text_buffer );
+		  return ostr.write( _text_buffer, buf_end - _text_buffer ); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__NATURAL_PRINTER_LEFT_TO_RIGHT_UTF8_C_STYLE_HPP
@@ -0,0 +1,67 @@
+
+#ifndef ML__PRINTERS__LR_PRINTERS_C_H
+#define ML__PRINTERS__LR_PRINTERS_C_H
+
+/* C interface of the printers, for linking from other languages (through
+ * cgo, cffi, JNI, ...).
+ * Every call across such boundary is expensive, so arrays of numbers should
+ * be printed by the batch functions ('lrp_print_*_array()'), which pay that
+ * cost once per array.
+ * A printer handle may be used by one thread at a time. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined( _WIN32 )
+#	if defined( LRP_BUILDING )
+#		define LRP_API __declspec( dllexport )
+#	else
+#		define LRP_API __declspec( dllimport )
+#	endif
+#else
+#	define LRP_API __attribute__(( visibility( "default" ) ))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Opaque printer handle. */
+typedef struct lrp_printer lrp_printer;
+
+/* Creates a printer for 'base' (2 to 36) and 'alphabet' (at least 'base'
+ * characters, or NULL for "0123456789abc...z").
+ * Returns NULL if the arguments are invalid, or memory is exhausted. */
+LRP_API lrp_printer* lrp_create( int base, const char* alphabet );
+
+/* Destroys the printer. NULL is ignored. */
+LRP_API void lrp_destroy( lrp_printer* printer );
+
+/* Returns maximal count of characters of one printed value (the sign
+ * included), so 'n' values with separators need at most
+ * 'n * (lrp_max_chars( printer ) + 1)' characters. */
+LRP_API int lrp_max_chars( const lrp_printer* printer );
+
+/* Print 'value' into 'out' of 'out_cap' characters, without appending
+ * null-character.
+ * Return count of printed characters, or -1 if 'out_cap' is not enough. */
+LRP_API int lrp_to_chars_u64( lrp_printer* printer, uint64_t value,
+		char* out, size_t out_cap );
+LRP_API int lrp_to_chars_i64( lrp_printer* printer, int64_t value,
+		char* out, size_t out_cap );
+
+/* Print 'n' values from 'values' into 'out' of 'out_cap' characters, every
+ * value followed by 'sep'. No null-character is appended.
+ * Return count of printed characters, or -1 if 'out_cap' is not enough or
+ * memory for temporary data could not be allocated (then content of 'out'
+ * is unspecified). */
+LRP_API ptrdiff_t lrp_print_u64_array( lrp_printer* printer,
+		const uint64_t* values, size_t n, char sep, char* out, size_t out_cap );
+LRP_API ptrdiff_t lrp_print_i64_array( lrp_printer* printer,
+		const int64_t* values, size_t n, char sep, char* out, size_t out_cap );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ML__PRINTERS__LR_PRINTERS_C_H */
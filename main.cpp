@@ -3,12 +3,62 @@
 #include <string>
 #include <sstream>
 #include <chrono>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <ctime>
 #include <cassert>
+#include <thread>
+
+#if defined( __SSE2__ ) || defined( _M_X64 )
+#include <immintrin.h>
+#endif
 
 #include "modulo_printer.hpp"
 #include "modulo_printer_2_digits.hpp"
 #include "lr_printer.hpp"
 #include "lr_printer_2_digits.hpp"
+#include "lr_printer_batch.hpp"
+#include "lr_printer_translated.hpp"
+#include "lr_printer_utf8.hpp"
+#include "lean_printer.hpp"
+#include "address_printers.hpp"
+#include "check_digit_printers.hpp"
+#include "hex_printer.hpp"
+#include "memoizing_printer.hpp"
+#include "mixed_radix_printer.hpp"
+#include "printer_composer.hpp"
+#include "table_free_printer.hpp"
+#include "constexpr_printer.hpp"
+#include "printer_stats.hpp"
+#include "value_capture.hpp"
+#include "field_printers.hpp"
+#include "record_writer.hpp"
+#include "string_column_builder.hpp"
+#include "json_writer.hpp"
+#include "metrics_writer.hpp"
+#include "resp_encoder.hpp"
+#include "timestamp_printer.hpp"
+#include "lr_printers_c.h"
+
+
+/// Size of buffers, passed to printer 'PrinterType' in the tests: its 
+/// 'BUFFER_SIZE_MIN', if it requires one, or enough for any 64-bit number.
+template< typename PrinterType, typename = void >
+struct test_buffer_size
+	: std::integral_constant< int, 64 + 7 >
+	{};
+
+template< typename PrinterType >
+struct test_buffer_size< PrinterType, 
+		decltype( (void)PrinterType::BUFFER_SIZE_MIN ) >
+	: std::integral_constant< int, 
+			std::max( 64 + 7, (int)PrinterType::BUFFER_SIZE_MIN ) >
+	{};
 
 
 /// Runs general tests for provided printer of natural numbers.
@@ -17,7 +67,7 @@ void test_printer( PrinterType& p )
 {
 	using namespace std::string_literals;
 
-	char buf[ 25 ];
+	char buf[ test_buffer_size< PrinterType >::value ];
 
 	p.print( 43, buf );
 	assert( buf == "43"s );
@@ -60,6 +110,1080 @@ void test_printer( PrinterType& p )
 }
 
 
+/// Tests that printer remains correct when switching between all bases, 
+/// by comparing it with the plain modulo printer.
+template< typename PrinterType >
+void test_base_switching( PrinterType& p )
+{
+	typedef typename PrinterType::number_type number_type;
+	const number_type nums[] = { 0, 1, 9, 10, 99, 100, 4'095, 65'535, 
+			2'147'483'647, std::numeric_limits< number_type >::max() };
+	ml::printers::modulo_printer< number_type > reference;
+	char buf[ test_buffer_size< PrinterType >::value ], reference_buf[ 64 + 7 ];
+	for ( short base = 2; base <= 16; ++base ) {
+		p.set_base( base );
+		reference.set_base( base );
+		reference.setup_default_alphabet();
+		for ( number_type num : nums ) {
+			p.print( num, buf );
+			reference.print( num, reference_buf );
+			assert( std::string( buf ) == reference_buf );
+		}
+	}
+	p.set_base( 10 );
+}
+
+
+/// Generates 'count' random numbers, with count of digits (in base 10)
+/// uniformly distributed in [1, max_digits].
+template< typename NumberType >
+std::vector< NumberType > generate_mixed_lengths( size_t count, int max_digits )
+{
+	std::mt19937_64 gen( 5'607 );
+	std::vector< NumberType > nums( count );
+	for ( NumberType& num : nums ) {
+		const int digits = (int)(gen() % max_digits) + 1;
+		NumberType low = 1;
+		for ( int i = 1; i < digits; ++i )
+			low *= 10;
+		num = low + (NumberType)(gen() % (unsigned long long)(low * 9));
+		if ( digits == 1 )
+			num = (NumberType)(gen() % 10);  // Allow zero too
+	}
+	return nums;
+}
+
+
+/// Tests that batch printer produces the same output, as printing the 
+/// numbers one by one.
+template< typename NumberType >
+void test_batch_printer( short base )
+{
+	std::vector< NumberType > nums = generate_mixed_lengths< NumberType >( 
+			1'000, std::numeric_limits< NumberType >::digits10 );
+	// Numbers of the maximal length, which are not generated above
+	const NumberType max_num = std::numeric_limits< NumberType >::max();
+	for ( NumberType i = 0; i < 100; ++i )
+		nums.push_back( max_num - i * (max_num / 200) );
+	ml::printers::lr_printer_2_digits< NumberType > single_printer( base );
+	ml::printers::lr_printer_batch< NumberType > batch_printer( base );
+	std::string expected;
+	char buf[ 64 + 7 ];
+	for ( NumberType num : nums ) {
+		expected += std::string( buf, single_printer.print( num, buf ) );
+		expected += '\n';
+	}
+	std::vector< char > batch_buf( nums.size() * sizeof(buf) );
+	size_t length = batch_printer.print( nums.data(), nums.size(), 
+			batch_buf.data(), '\n' );
+	assert( std::string( batch_buf.data(), length ) == expected );
+	// Printing once more, with the same printer
+	length = batch_printer.print( nums.data() + 1, 1, batch_buf.data(), ',' );
+	assert( std::string( batch_buf.data(), length ) 
+			== std::string( buf, single_printer.print( nums[ 1 ], buf ) ) + "," );
+}
+
+
+/// Tests lazy obtaining of digits by 'lr_printer'.
+template< typename NumberType >
+void test_digit_range()
+{
+	ml::printers::lr_printer< NumberType > p;
+	const std::vector< NumberType > nums = 
+			generate_mixed_lengths< NumberType >( 1'000, 
+					std::numeric_limits< NumberType >::digits10 );
+	char buf[ 64 + 7 ];
+	for ( short base : { 10, 2, 16 } ) {
+		p.set_base( base );
+		for ( NumberType num : nums ) {
+			const int length = p.print( num, buf );
+			const auto range = p.digits( num );
+			assert( range.size() == length );
+			// All digits
+			std::string text;
+			int digits_sum = 0;
+			for ( auto it = range.begin(); it != range.end(); ++it ) {
+				text += it.character();
+				digits_sum += *it;
+			}
+			assert( text == buf );
+			int expected_sum = 0;
+			for ( int i = 0; i < length; ++i )
+				expected_sum += (buf[ i ] <= '9' ? buf[ i ] - '0' : buf[ i ] - 'a' + 10);
+			assert( digits_sum == expected_sum );
+			// Prefixes
+			for ( int prefix_length = 0; prefix_length <= length; ++prefix_length )
+				assert( p.has_prefix( num, std::string( buf, prefix_length ) ) );
+			std::string other( buf );
+			other.back() = (other.back() == '1' ? '0' : '1');
+			assert( ! p.has_prefix( num, other ) );
+			assert( ! p.has_prefix( num, std::string( buf ) + "0" ) );
+		}
+	}
+	p.set_base( 10 );
+	assert( p.has_prefix( 42'000'123, "42" ) );
+	assert( ! p.has_prefix( 4'200, "42001" ) );
+	assert( p.digits( 0 ).size() == 1 && *p.digits( 0 ).begin() == 0 );
+}
+
+
+/// Tests that 'lr_printer_translated' with custom alphabets prints the same 
+/// as 'lr_printer' with the same alphabets.
+template< typename NumberType >
+void test_translated_printer()
+{
+	// Crockford's base-32 alphabet (used also for smaller bases)
+	const std::string alphabet = "0123456789ABCDEFGHJKMNPQRSTVWXYZ";
+	const std::vector< NumberType > nums = 
+			generate_mixed_lengths< NumberType >( 1'000, 
+					std::numeric_limits< NumberType >::digits10 );
+	char buf[ 64 + 7 ], reference_buf[ 64 + 7 ];
+	for ( short base : { 2, 10, 16, 17, 32 } ) {
+		ml::printers::lr_printer_translated< NumberType > p( base, alphabet );
+		ml::printers::lr_printer< NumberType > reference( base, alphabet );
+		for ( NumberType num : nums ) {
+			const int length = p.print( num, buf );
+			reference.print( num, reference_buf );
+			assert( std::string( buf ) == reference_buf );
+			assert( length == (int)strlen( reference_buf ) );
+		}
+	}
+}
+
+
+/// Tests printing with multi-byte UTF-8 digits, by comparing with the 
+/// ASCII digits of 'lr_printer', replaced one by one.
+template< typename NumberType >
+void test_utf8_printer()
+{
+	typedef ml::printers::lr_printer_utf8< NumberType > printer_type;
+	const char* const alphabets[] = {
+		u8"\u0660\u0661\u0662\u0663\u0664\u0665\u0666\u0667\u0668\u0669",  // Arabic-Indic
+		u8"\u0966\u0967\u0968\u0969\u096a\u096b\u096c\u096d\u096e\u096f",  // Devanagari
+		u8"\uff10\uff11\uff12\uff13\uff14\uff15\uff16\uff17\uff18\uff19",  // Fullwidth
+		u8"0\u00b9\u00b2\u00b3\u2074\u2075\u2076\u2077\u2078\u2079",         // Superscript
+		u8"0\U0001d7cf\U0001d7d0\U0001d7d1\U0001d7d2\U0001d7d3\U0001d7d4\U0001d7d5\U0001d7d6\U0001d7d7"
+	};
+	const std::vector< NumberType > nums = 
+			generate_mixed_lengths< NumberType >( 1'000, 
+					std::numeric_limits< NumberType >::digits10 );
+	ml::printers::lr_printer< NumberType > reference;
+	char buf[ printer_type::BUFFER_SIZE_MIN ], reference_buf[ 64 + 7 ];
+	for ( const char* alphabet : alphabets ) {
+		printer_type p( 10, alphabet );
+		std::vector< std::string > digits;
+		const bool valid = printer_type::split_utf8( alphabet, digits );
+		assert( valid && digits.size() == 10 );
+		for ( NumberType num : nums ) {
+			const int length = p.print( num, buf );
+			reference.print( num, reference_buf );
+			std::string expected;
+			for ( const char* ptr = reference_buf; *ptr; ++ptr )
+				expected += digits[ *ptr - '0' ];
+			assert( buf == expected );
+			assert( length == (int)expected.length() );
+		}
+	}
+	// Invalid alphabets are rejected
+	printer_type p;
+	assert( ! p.set_alphabet( "0123456789\xff" ) );
+	assert( ! p.set_alphabet( "0123456789\xd9" ) );
+	assert( ! p.set_alphabet( u8"\u0660\u0661" ) );  // Too short
+	p.print( 1'234, buf );
+	assert( std::string( buf ) == "1234" );
+	// Bases above size of the alphabet are rejected
+	printer_type arabic_printer( 10, alphabets[ 0 ] );
+	assert( ! arabic_printer.set_base( 16 ) );
+	assert( arabic_printer.get_base() == 10 );
+	arabic_printer.print( 42, buf );
+	assert( std::string( buf ) == u8"\u0664\u0662" );
+	assert( arabic_printer.set_base( 8 ) );
+	arabic_printer.print( 8, buf );
+	assert( std::string( buf ) == u8"\u0661\u0660" );
+	// Constructed with an invalid alphabet, the printer uses the default one
+	printer_type invalid_printer( 16, "0123456789\xff" );
+	invalid_printer.print( 0xbeef, buf );
+	assert( std::string( buf ) == "beef" );
+}
+
+
+/// Tests printer of characters 'CharT', by comparing it with the same 
+/// printer of 'char'.
+template< template< typename, typename > class PrinterTemplate, typename CharT >
+void test_wide_printer()
+{
+	typedef long long number_type;
+	typedef std::basic_string< CharT > string_type;
+	PrinterTemplate< number_type, CharT > p;
+	PrinterTemplate< number_type, char > reference;
+	const std::vector< number_type > nums = 
+			generate_mixed_lengths< number_type >( 1'000, 18 );
+	CharT buf[ 64 + 7 ];
+	char reference_buf[ 64 + 7 ];
+	for ( short base : { 2, 10, 16 } ) {
+		p.set_base( base );
+		p.setup_default_alphabet();
+		reference.set_base( base );
+		reference.setup_default_alphabet();
+		for ( number_type num : nums ) {
+			const int length = p.print( num, buf );
+			const int reference_length = reference.print( num, reference_buf );
+			assert( length == reference_length );
+			assert( string_type( buf ) 
+					== string_type( reference_buf, reference_buf + reference_length ) );
+		}
+	}
+	// Arabic-Indic digits, which don't fit in 'char'
+	string_type alphabet;
+	for ( int digit = 0; digit < 10; ++digit )
+		alphabet += (CharT)(0x0660 + digit);
+	p.set_base( 10 );
+	p.set_alphabet( alphabet );
+	p.print( 1'234, buf );
+	assert( string_type( buf ) == string_type( { CharT( 0x0661 ), CharT( 0x0662 ), 
+			CharT( 0x0663 ), CharT( 0x0664 ) } ) );
+}
+
+
+/// Tests the table-free printer of given base, by comparing it with 
+/// 'composed_printer' on numbers of mixed lengths, and on powers of the base 
+/// and their neighbours.
+template< typename NumberType, short Base >
+void test_table_free_printer()
+{
+	ml::printers::table_free_printer< NumberType, Base > p;
+	ml::printers::composed_printer< NumberType > reference( Base );
+	std::vector< NumberType > nums = generate_mixed_lengths< NumberType >( 
+			1'000, std::numeric_limits< NumberType >::digits10 );
+	nums.push_back( 0 );
+	nums.push_back( std::numeric_limits< NumberType >::max() );
+	for ( NumberType power = 1; power <= std::numeric_limits< NumberType >::max() / Base; ) {
+		power *= Base;
+		nums.push_back( power - 1 );
+		nums.push_back( power );
+	}
+	char buf[ 64 + 7 ], reference_buf[ 64 + 7 ];
+	for ( NumberType num : nums ) {
+		assert( p.print( num, buf ) == reference.print( num, reference_buf ) );
+		assert( std::string( buf ) == reference_buf );
+	}
+	std::ostringstream ostr;
+	p.print( (NumberType)Base, ostr );
+	assert( ostr.str() == "10" );
+}
+
+
+/// Tests printing in constant expressions, and compares its runtime results
+/// with 'composed_printer' on numbers of mixed lengths.
+void test_constexpr_printing()
+{
+	using namespace ml::printers;
+	// At compile time
+	constexpr auto s = to_array< 12'345 >();
+	static_assert( s.size() == 5 && s.equals( "12345" ), "" );
+	static_assert( decltype( s )::CAPACITY == 5, "" );
+	static_assert( to_array< 0 >().equals( "0" ), "" );
+	static_assert( to_array< -255, 16 >().equals( "-ff" ), "" );
+	static_assert( to_array< 35, 36 >().equals( "z" ), "" );
+	static_assert( to_array< std::numeric_limits< long long >::min() >().equals( 
+			"-9223372036854775808" ), "" );
+	static_assert( to_char_array( std::numeric_limits< unsigned long long >::max() )
+			.equals( "18446744073709551615" ), "" );
+	static_assert( to_char_array( (unsigned char)5, 2 ).equals( "101" ), "" );
+	// Minimal values in base 2 take all the digits and the sign
+	static_assert( to_char_array( (signed char)-128, 2 ).equals( "-10000000" ), "" );
+	static_assert( to_char_array( std::numeric_limits< int >::min(), 2 ).equals( 
+			"-10000000000000000000000000000000" ), "" );
+	static_assert( to_char_array( std::numeric_limits< long long >::min(), 2 ).equals( 
+			"-1000000000000000000000000000000000000000000000000000000000000000" ), "" );
+	static_assert( to_char_array( std::numeric_limits< unsigned long long >::max(), 2 )
+			.size() == 64, "" );
+	// A table of literals, which is not built at runtime
+	static constexpr char_array< 3 > codes[] = { 
+			to_array< 200 >(), to_array< 404 >(), to_array< -1 >() };
+	assert( std::string( codes[ 1 ].c_str() ) == "404" );
+	assert( codes[ 2 ].to_string() == "-1" );
+	// Not enough space
+	char small[ 3 ];
+	assert( to_chars( small, small + 3, 1'000 ) == nullptr );
+	assert( to_chars( small, small + 3, -100 ) == nullptr );
+	assert( to_chars( small, small + 3, 999 ) == small + 3 );
+	// At runtime
+	composed_printer< long long > reference;
+	char reference_buf[ 64 + 7 ];
+	for ( short base : { 2, 7, 10, 16, 36 } ) {
+		reference.set_base( base );
+		for ( long long num : generate_mixed_lengths< long long >( 1'000, 18 ) ) {
+			reference.print( num, reference_buf );
+			assert( to_char_array( num, base ).to_string() == reference_buf );
+			assert( to_char_array( -num, base ).to_string() 
+					== (num == 0 ? "" : "-") + std::string( reference_buf ) );
+		}
+	}
+	std::ostringstream ostr;
+	ostr << to_array< 42 >();
+	assert( ostr.str() == "42" );
+}
+
+
+/// Runs general tests for the printer, composed of given parts, and compares
+/// it with 'lr_printer_2_digits' on numbers of mixed lengths.
+template< typename DigitEngine, typename TablePolicy >
+void test_composed_printer()
+{
+	typedef long long number_type;
+	ml::printers::composed_printer< number_type, DigitEngine, TablePolicy > p;
+	test_printer( p );
+	test_base_switching( p );
+	ml::printers::lr_printer_2_digits< number_type > reference;
+	const std::vector< number_type > nums = 
+			generate_mixed_lengths< number_type >( 1'000, 18 );
+	char buf[ 64 + 7 ], reference_buf[ 64 + 7 ];
+	for ( number_type num : nums ) {
+		assert( p.print( num, buf ) == reference.print( num, reference_buf ) );
+		assert( std::string( buf ) == reference_buf );
+	}
+	// Bases above 16
+	p.set_base( 36 );
+	p.print( std::numeric_limits< number_type >::max(), buf );
+	assert( std::string( buf ) == "1y2p0ij32e8e7" );
+}
+
+
+/// Tests the printer, composed of given parts, on all values of 8-bit types 
+/// in bases, square of which doesn't fit into them.
+template< typename DigitEngine, typename NumberType >
+void test_composed_printer_8_bit()
+{
+	ml::printers::composed_printer< NumberType, DigitEngine > p;
+	ml::printers::composed_printer< long long > reference;
+	char buf[ 16 ], reference_buf[ 16 ];
+	for ( short base : { 16, 36 } ) {
+		p.set_base( base );
+		reference.set_base( base );
+		for ( int num = 0; num <= std::numeric_limits< NumberType >::max(); ++num ) {
+			assert( p.print( (NumberType)num, buf ) 
+					== reference.print( num, reference_buf ) );
+			assert( std::string( buf ) == reference_buf );
+		}
+	}
+}
+
+template< typename DigitEngine >
+void test_composed_printer_8_bit()
+{
+	test_composed_printer_8_bit< DigitEngine, unsigned char >();
+	test_composed_printer_8_bit< DigitEngine, signed char >();
+}
+
+
+/// Tests that copies of the composed printer with a custom alphabet print 
+/// by their own pairs, also after the source is changed or destroyed.
+template< typename TablePolicy >
+void test_composed_printer_copy()
+{
+	typedef ml::printers::composed_printer< long long, 
+			ml::printers::lr_2_digits_engine, TablePolicy > printer_type;
+	char buf[ 64 + 7 ];
+	std::unique_ptr< printer_type > source( 
+			new printer_type( 16, "0123456789ABCDEF" ) );
+	printer_type copy( *source );
+	printer_type assigned;
+	assigned = *source;
+	source->set_alphabet( "0123456789abcdef" );
+	copy.print( 0xbeef, buf );
+	assert( std::string( buf ) == "BEEF" );
+	source.reset();
+	copy.print( 0xc0ffee, buf );
+	assert( std::string( buf ) == "C0FFEE" );
+	assigned.print( 0xface, buf );
+	assert( std::string( buf ) == "FACE" );
+}
+
+
+/// Tests printing of signed and fixed-point fields.
+void test_field_printers()
+{
+	char buf[ 32 ];
+	ml::printers::integer_field_printer< long long > int_printer;
+	assert( std::string( buf, int_printer.print( -9'223'372'036'854'775'807LL - 1, buf ) )
+			== "-9223372036854775808" );
+	assert( std::string( buf, int_printer.print( 0, buf ) ) == "0" );
+	assert( std::string( buf, int_printer.print( 507, buf ) ) == "507" );
+
+	ml::printers::fixed_point_field_printer< int > fixed_printer( 2 );
+	assert( std::string( buf, fixed_printer.print( -12'345, buf ) ) == "-123.45" );
+	assert( std::string( buf, fixed_printer.print( 5, buf ) ) == "0.05" );
+	assert( std::string( buf, fixed_printer.print( 100, buf ) ) == "1.00" );
+	fixed_printer.set_scale( 0 );
+	assert( std::string( buf, fixed_printer.print( -7, buf ) ) == "-7" );
+}
+
+
+/// Tests writing of CSV and TSV records.
+void test_record_writer()
+{
+	using namespace ml::printers;
+	std::string csv;
+	{
+		// Small buffer, so flushes happen in the middle
+		record_writer< string_sink, 
+				integer_column< int >, 
+				fixed_point_column< long long, 3 >, 
+				string_column > writer( string_sink( csv ), ',', 64 );
+		writer.write_line( "id,price,name" );
+		for ( int i = 0; i < 100; ++i )
+			writer.write_row( i - 50, i * 1'001LL, "item" );
+		writer.write_row( 7, -5, "a, \"quoted\" one" );
+	}
+	std::string expected = "id,price,name\n";
+	for ( int i = 0; i < 100; ++i ) {
+		std::ostringstream ostr;
+		ostr << (i - 50) << ',' << (i * 1'001 / 1'000) << '.' 
+				<< (i * 1'001 % 1'000 < 100 ? "0" : "") 
+				<< (i * 1'001 % 1'000 < 10 ? "0" : "") 
+				<< (i * 1'001 % 1'000) << ",item\n";
+		expected += ostr.str();
+	}
+	expected += "7,-0.005,\"a, \"\"quoted\"\" one\"\n";
+	assert( csv == expected );
+
+	std::string tsv;
+	{
+		record_writer< string_sink, string_column, integer_column< unsigned > > 
+				writer( string_sink( tsv ), '\t' );
+		writer.write_row( std::string( "a,b" ), 4'294'967'295u );
+		// Row longer than the buffer
+		writer.write_row( std::string( 100'000, 'x' ), 0 );
+	}
+	assert( tsv == "a,b\t4294967295\n" + std::string( 100'000, 'x' ) + "\t0\n" );
+}
+
+
+/// Tests building of string columns, in a single and in several threads.
+template< typename OffsetType >
+void test_string_column_builder( size_t threads_count )
+{
+	std::vector< long long > nums = generate_mixed_lengths< long long >( 
+			300'000, 18 );
+	for ( size_t i = 0; i < nums.size(); i += 7 )
+		nums[ i ] = -nums[ i ];
+	nums.push_back( std::numeric_limits< long long >::min() );
+	ml::printers::string_column_builder< long long, OffsetType > builder( threads_count );
+	ml::printers::string_column_data< OffsetType > column;
+	const bool built = builder.build( nums, column );
+	assert( built );
+	assert( column.offsets.size() == nums.size() + 1 );
+	assert( column.offsets.front() == 0 );
+	assert( (size_t)column.offsets.back() == column.data.size() );
+	for ( size_t i = 0; i < nums.size(); ++i )
+		assert( std::string( column.data.data() + column.offsets[ i ], 
+				column.data.data() + column.offsets[ i + 1 ] ) 
+				== std::to_string( nums[ i ] ) );
+	// Empty column
+	const bool built_empty = builder.build( nums.data(), 0, column );
+	assert( built_empty );
+	assert( column.offsets.size() == 1 && column.data.empty() );
+}
+
+
+/// Tests writing of JSON text.
+void test_json_writer()
+{
+	ml::printers::json_writer writer( 8 );  // Small, to check the growth
+	const auto id_key = writer.add_key( "id" );
+	const auto price_key = writer.add_key( "price" );
+	const auto name_key = writer.add_key( "na\"me" );
+	writer.begin_array();
+	for ( int i = 0; i < 3; ++i ) {
+		writer.begin_object();
+		writer.member( id_key, i - 1 );
+		writer.key( price_key );
+		writer.value_fixed_point( 1'050LL * i, 2 );
+		writer.member( name_key, "a\tb" );
+		writer.key( "tags" );
+		writer.begin_array();
+		writer.value( 18'446'744'073'709'551'615ULL );
+		writer.value( true );
+		writer.value_null();
+		writer.begin_array();
+		writer.end_array();
+		writer.end_array();
+		writer.end_object();
+	}
+	writer.end_array();
+	std::string expected = "[";
+	for ( int i = 0; i < 3; ++i ) {
+		if ( i > 0 )
+			expected += ",";
+		expected += "{\"id\":" + std::to_string( i - 1 ) 
+				+ ",\"price\":" + (i == 0 ? "0.00" : i == 1 ? "10.50" : "21.00")
+				+ ",\"na\\\"me\":\"a\\tb\""
+				+ ",\"tags\":[18446744073709551615,true,null,[]]}";
+	}
+	expected += "]";
+	assert( writer.str() == expected );
+	// Reusing the writer
+	writer.clear();
+	writer.begin_object();
+	writer.member( id_key, std::string( "\x01" ) );
+	writer.end_object();
+	assert( writer.str() == "{\"id\":\"\\u0001\"}" );
+}
+
+
+/// Tests writing of metrics, by scraping them into a file.
+void test_metrics_writer()
+{
+	ml::printers::metrics_writer writer( 16 );  // Small, to check the growth
+	const auto family = writer.add_family( "http_requests_total", "counter", 
+			"Total requests.\nBy code" );
+	const auto ok = writer.add_series( "http_requests_total", 
+			{ { "code", "200" }, { "path", "/a\"b\\" } } );
+	const auto error = writer.add_series( "http_requests_total", { { "code", "500" } } );
+	const auto temperature = writer.add_series( "temperature" );
+	const std::string expected_header = "# HELP http_requests_total Total requests.\\nBy code\n"
+			"# TYPE http_requests_total counter\n";
+	for ( int scrape = 0; scrape < 2; ++scrape ) {
+		writer.begin_scrape();
+		writer.write_family( family );
+		writer.write( ok, 1'000 + scrape );
+		writer.write( error, -3, 1'700'000'000'000LL );
+		writer.write_fixed_point( temperature, -1'205, 2 );
+		// Scrape into a file, and read it back
+		FILE* file = tmpfile();
+		assert( file != nullptr );
+		ml::printers::file_sink sink( file );
+		writer.flush( sink );
+		rewind( file );
+		char buf[ 512 ];
+		const size_t length = fread( buf, 1, sizeof(buf), file );
+		fclose( file );
+		assert( std::string( buf, length ) == expected_header
+				+ "http_requests_total{code=\"200\",path=\"/a\\\"b\\\\\"} " 
+						+ std::to_string( 1'000 + scrape ) + "\n"
+				+ "http_requests_total{code=\"500\"} -3 1700000000000\n"
+				+ "temperature -12.05\n" );
+	}
+}
+
+
+/// Decodes one RESP value, starting at 'ptr', into a readable form: 
+/// arrays as "[a b]", bulk strings as "'str'", integers as ":5", simple 
+/// strings as "+str", and the null bulk string as "nil".
+/// Advances 'ptr' past the decoded value.
+std::string decode_resp( const char*& ptr )
+{
+	const char type = *(ptr++);
+	const char* line_end = strstr( ptr, "\r\n" );
+	assert( line_end != nullptr );
+	const std::string line( ptr, line_end );
+	ptr = line_end + 2;
+	switch ( type ) {
+		case '+':
+			return "+" + line;
+		case ':':
+			return ":" + std::to_string( std::stoll( line ) );
+		case '$': {
+			const long long length = std::stoll( line );
+			if ( length < 0 )
+				return "nil";
+			const std::string str( ptr, (size_t)length );
+			ptr += length;
+			assert( ptr[ 0 ] == '\r' && ptr[ 1 ] == '\n' );
+			ptr += 2;
+			return "'" + str + "'";
+		}
+		case '*': {
+			std::string result = "[";
+			for ( long long i = 0, count = std::stoll( line ); i < count; ++i )
+				result += (i > 0 ? " " : "") + decode_resp( ptr );
+			return result + "]";
+		}
+	}
+	assert( false );
+	return "";
+}
+
+
+/// Tests encoding of RESP data, by decoding it back.
+void test_resp_encoder()
+{
+	ml::printers::resp_encoder encoder( 8 );  // Small, to check the growth
+	encoder.write_command( "SET", "key", std::string( 1'500, 'v' ) );
+	encoder.write_command( "EXPIRE", "key", 3'600 );
+	encoder.write_command( "INCRBY", "counter", -25LL );
+	encoder.write_integer( -9'223'372'036'854'775'807LL - 1 );
+	encoder.write_integer( 1'023 );
+	encoder.write_null_bulk_string();
+	encoder.write_simple_string( "OK" );
+	encoder.write_array_header( 2'000 );
+	for ( int i = 0; i < 2'000; ++i )
+		encoder.write_bulk_string( i );
+	const std::string data = encoder.str() + '\0';
+	const char* ptr = data.c_str();
+	assert( decode_resp( ptr ) == "['SET' 'key' '" + std::string( 1'500, 'v' ) + "']" );
+	assert( decode_resp( ptr ) == "['EXPIRE' 'key' '3600']" );
+	assert( decode_resp( ptr ) == "['INCRBY' 'counter' '-25']" );
+	assert( decode_resp( ptr ) == ":-9223372036854775808" );
+	assert( decode_resp( ptr ) == ":1023" );
+	assert( decode_resp( ptr ) == "nil" );
+	assert( decode_resp( ptr ) == "+OK" );
+	std::string expected = "[";
+	for ( int i = 0; i < 2'000; ++i )
+		expected += (i > 0 ? " '" : "'") + std::to_string( i ) + "'";
+	assert( decode_resp( ptr ) == expected + "]" );
+	assert( *ptr == '\0' );  // All data is decoded
+	// Exact encoding of headers
+	encoder.clear();
+	encoder.write_command( "GET", "k" );
+	assert( encoder.str() == "*2\r\n$3\r\nGET\r\n$1\r\nk\r\n" );
+}
+
+
+/// Tests printing of timestamps, by comparing with 'strftime()'.
+void test_timestamp_printer()
+{
+	using namespace std::string_literals;
+	ml::printers::timestamp_printer printer;
+	char buf[ ml::printers::timestamp_printer::LENGTH + 1 ];
+
+	assert( printer.print( 0, buf ) == 30 );
+	assert( buf == "1970-01-01T00:00:00.000000000Z"s );
+	printer.print( 1'700'000'000'123'456'789LL, buf );
+	assert( buf == "2023-11-14T22:13:20.123456789Z"s );
+	printer.print( 951'782'400'000'000'000LL, buf );  // Leap day
+	assert( buf == "2000-02-29T00:00:00.000000000Z"s );
+	printer.print( -1, buf );
+	assert( buf == "1969-12-31T23:59:59.999999999Z"s );
+
+	// Increasing timestamps (as in logs), crossing many hours and days
+	std::mt19937_64 gen( 43 );
+	long long epoch_ns = 1'600'000'000'000'000'000LL;
+	for ( int i = 0; i < 10'000; ++i ) {
+		epoch_ns += (long long)(gen() % 100'000'000'000'000ULL);
+		printer.print( epoch_ns, buf );
+		const std::time_t seconds = (std::time_t)(epoch_ns / 1'000'000'000);
+		char expected[ 64 ];
+		const size_t length = strftime( expected, sizeof(expected), 
+				"%Y-%m-%dT%H:%M:%S", std::gmtime( &seconds ) );
+		snprintf( expected + length, sizeof(expected) - length, ".%09dZ", 
+				(int)(epoch_ns % 1'000'000'000) );
+		assert( buf == std::string( expected ) );
+	}
+}
+
+
+/// Tests printing of IPv4 and IPv6 addresses.
+void test_address_printers()
+{
+	using namespace std::string_literals;
+	char buf[ ml::printers::ipv6_printer::BUFFER_SIZE_MIN ];
+
+	ml::printers::ipv4_printer ipv4;
+	assert( ipv4.print( 0x7f000001u, buf ) == 9 );
+	assert( buf == "127.0.0.1"s );
+	assert( ipv4.print( 0xffffffffu, buf ) == 15 );
+	assert( buf == "255.255.255.255"s );
+	const uint8_t ipv4_bytes[ 4 ] = { 10, 0, 99, 200 };
+	ipv4.print( ipv4_bytes, buf );
+	assert( buf == "10.0.99.200"s );
+	for ( unsigned octet = 0; octet < 256; ++octet ) {
+		ipv4.print( octet * 0x01010101u, buf );
+		const std::string o = std::to_string( octet );
+		assert( buf == o + "." + o + "." + o + "." + o );
+	}
+
+	ml::printers::ipv6_printer ipv6;
+	// Checks that address with given 8 groups is printed as 'expected'
+	auto check = [&]( std::initializer_list< unsigned > groups, const char* expected ) {
+		uint8_t bytes[ 16 ];
+		int i = 0;
+		for ( unsigned group : groups ) {
+			bytes[ i++ ] = (uint8_t)(group >> 8);
+			bytes[ i++ ] = (uint8_t)group;
+		}
+		assert( i == 16 );
+		const int length = ipv6.print( bytes, buf );
+		assert( buf == std::string( expected ) );
+		assert( length == (int)strlen( expected ) );
+	};
+	check( { 0, 0, 0, 0, 0, 0, 0, 0 }, "::" );
+	check( { 0, 0, 0, 0, 0, 0, 0, 1 }, "::1" );
+	check( { 1, 0, 0, 0, 0, 0, 0, 0 }, "1::" );
+	check( { 0x2001, 0xdb8, 0, 0, 0, 0, 0x2, 0x1 }, "2001:db8::2:1" );
+	check( { 0x2001, 0xdb8, 0, 1, 1, 1, 1, 1 }, "2001:db8:0:1:1:1:1:1" );
+	check( { 0x2001, 0xdb8, 0, 0, 1, 0, 0, 1 }, "2001:db8::1:0:0:1" );
+	check( { 0x2001, 0, 0, 1, 0, 0, 0, 1 }, "2001:0:0:1::1" );
+	check( { 0xffff, 0xabcd, 0x123, 0x45, 0x6, 0xf000, 0x0f00, 0x00f0 }, 
+			"ffff:abcd:123:45:6:f000:f00:f0" );
+	check( { 0, 0, 0, 0, 0, 0xffff, 0xc000, 0x0280 }, "::ffff:192.0.2.128" );
+	check( { 0xfe80, 0, 0, 0, 0x1ff, 0xfe23, 0x4567, 0x890a }, "fe80::1ff:fe23:4567:890a" );
+}
+
+
+/// Tests printing with check digits, by comparing with check digits 
+/// calculated over the printed text.
+void test_check_digit_printers()
+{
+	using namespace std::string_literals;
+	namespace mp = ml::printers;
+	char buf[ 32 ];
+
+	// Known examples
+	mp::check_digit_printer< long long, mp::luhn_algorithm > luhn;
+	luhn.print( 7'992'739'871LL, buf );
+	assert( buf == "79927398713"s );
+	mp::check_digit_printer< long long, mp::ean_algorithm > ean13( 12 );
+	ean13.print( 400'638'133'393LL, buf );
+	assert( buf == "4006381333931"s );
+	mp::check_digit_printer< unsigned long long, mp::ean_algorithm > upc( 11 );
+	upc.print( 3'600'029'145ULL, buf );
+	assert( buf == "036000291452"s );
+	mp::check_digit_printer< int, mp::isbn10_algorithm > isbn10( 9 );
+	isbn10.print( 30'640'615, buf );
+	assert( buf == "0306406152"s );
+	isbn10.print( 8'044'2957, buf );
+	assert( buf == "080442957X"s );
+	mp::check_digit_printer< long long, mp::mod97_algorithm > mod97;
+	int check;
+	*mod97.print_digits( 123'456'789, buf, check ) = '\0';
+	assert( buf == "123456789"s );
+	assert( check == 78 && mod97.check_value( 123'456'789 ) == 78 );
+
+	// Random numbers
+	std::mt19937_64 generator( 66 );
+	for ( int i = 0; i < 10'000; ++i ) {
+		const long long x = (long long)(generator() >> (1 + generator() % 63));
+		std::string digits = std::to_string( x );
+		// Luhn
+		int sum = 0;
+		for ( size_t k = 0; k < digits.length(); ++k ) {
+			int d = digits[ digits.length() - 1 - k ] - '0';
+			if ( k % 2 == 0 )
+				d = (2 * d > 9 ? 2 * d - 9 : 2 * d);
+			sum += d;
+		}
+		luhn.print( x, buf );
+		assert( buf == digits + (char)('0' + (10 - sum % 10) % 10) );
+		// EAN
+		sum = 0;
+		for ( size_t k = 0; k < digits.length(); ++k )
+			sum += (digits[ digits.length() - 1 - k ] - '0') * (k % 2 == 0 ? 3 : 1);
+		mp::check_digit_printer< long long, mp::ean_algorithm > ean;
+		ean.print( x, buf );
+		assert( buf == digits + (char)('0' + (10 - sum % 10) % 10) );
+		// ISBN-10 (weights grow from the right)
+		sum = 0;
+		for ( size_t k = 0; k < digits.length(); ++k )
+			sum += (digits[ digits.length() - 1 - k ] - '0') * (int)(k + 2);
+		mp::check_digit_printer< long long, mp::isbn10_algorithm > isbn;
+		isbn.print( x, buf );
+		const int isbn_check = (11 - sum % 11) % 11;
+		assert( buf == digits + (isbn_check == 10 ? 'X' : (char)('0' + isbn_check)) );
+		// MOD 97-10: the number with check digits gives remainder 1
+		mod97.print( x, buf );
+		int remainder = 0;
+		for ( const char* ptr = buf; *ptr; ++ptr )
+			remainder = (remainder * 10 + (*ptr - '0')) % 97;
+		assert( remainder == 1 );
+		assert( std::string( buf, digits.length() ) == digits );
+	}
+}
+
+
+/// Tests printing of durations and other mixed-radix numbers, by comparing 
+/// with fields obtained by modulos.
+void test_mixed_radix_printer()
+{
+	using namespace std::string_literals;
+	// Durations in microseconds
+	ml::printers::mixed_radix_printer< long long > durations( 
+			{ 1000, 1000, 60, 60, 24 }, { "", ".", ":", ":", "d " } );
+	std::vector< char > buf( durations.get_length_max() + 1 );
+	assert( durations.print( 90'061'004'005LL, buf.data() ) == 18 );
+	assert( buf.data() == "1d 01:01:01.004005"s );
+	durations.print( 0, buf.data() );
+	assert( buf.data() == "0d 00:00:00.000000"s );
+	durations.print( std::numeric_limits< long long >::max(), buf.data() );
+	assert( buf.data() == "106751991d 04:00:54.775807"s );
+	std::mt19937_64 generator( 64 );
+	for ( int i = 0; i < 10'000; ++i ) {
+		const long long x = (long long)(generator() >> (1 + generator() % 63));
+		durations.print( x, buf.data() );
+		char expected[ 64 ];
+		snprintf( expected, sizeof( expected ), "%lldd %02lld:%02lld:%02lld.%03lld%03lld", 
+				x / 86'400'000'000LL, x / 3'600'000'000LL % 24, x / 60'000'000 % 60, 
+				x / 1'000'000 % 60, x / 1'000 % 1'000, x % 1'000 );
+		assert( buf.data() == std::string( expected ) );
+	}
+	// Version numbers, odd widths
+	ml::printers::mixed_radix_printer< unsigned > versions( 
+			{ 10, 100'000, 1'000 }, { "-r", ".", "." } );
+	buf.resize( versions.get_length_max() + 1 );
+	versions.print( 1'002'000'453u, buf.data() );
+	assert( buf.data() == "1.002.00045-r3"s );
+	std::ostringstream ostr;
+	versions.print( 0u, ostr );
+	assert( ostr.str() == "0.000.00000-r0" );
+}
+
+
+/// Tests merging of the printers statistics from several threads, and (if 
+/// the statistics are enabled) reporting to them by the printers.
+void test_printer_stats()
+{
+	typedef ml::printers::printer_stats stats_type;
+	ml::printers::printer_stats::reset();
+	const int id = stats_type::get_printer_id( "test_printer" );
+	assert( stats_type::get_printer_id( "test_printer" ) == id );
+	// Threads, which exit before collecting, and the current one
+	std::vector< std::thread > threads;
+	for ( int t = 0; t < 4; ++t )
+		threads.emplace_back( [id, t]() {
+				for ( int i = 0; i < 1'000; ++i )
+					stats_type::on_print( id, stats_type::SINK_BUFFER, t + 1, 10 ); } );
+	for ( std::thread& thread : threads )
+		thread.join();
+	stats_type::on_print( id, stats_type::SINK_FILE, 80, 1'000 );
+	stats_type::on_helper_data_growth( id );
+	const stats_type::printer_counters counters = stats_type::collect( "test_printer" );
+	assert( counters.calls == 4'001 );
+	assert( counters.digits == (1 + 2 + 3 + 4) * 1'000 + 80 );
+	assert( counters.lengths[ 3 ] == 1'000 );
+	assert( counters.lengths[ stats_type::LENGTH_MAX ] == 1 );
+	assert( counters.helper_data_growths == 1 );
+	assert( counters.sink_calls[ stats_type::SINK_BUFFER ] == 4'000 );
+	assert( counters.sink_nanoseconds[ stats_type::SINK_BUFFER ] == 40'000 );
+	assert( counters.sink_calls[ stats_type::SINK_FILE ] == 1 );
+	assert( counters.sink_calls[ stats_type::SINK_STREAM ] == 0 );
+	stats_type::reset();
+	assert( stats_type::collect( "test_printer" ).calls == 0 );
+	assert( stats_type::collect( "unknown_printer" ).calls == 0 );
+#if defined( ML_PRINTERS_STATS )
+	// Reporting by the printers
+	ml::printers::lr_printer_2_digits< long long > p;
+	char buf[ 64 + 7 ];
+	p.print( 5, buf );
+	p.print( 12'345, buf );
+	std::ostringstream ostr;
+	p.print( 123, ostr );
+	const stats_type::printer_counters printer_counters 
+			= stats_type::collect( "lr_printer_2_digits" );
+	assert( printer_counters.calls == 3 );
+	assert( printer_counters.digits == 1 + 5 + 3 );
+	assert( printer_counters.lengths[ 5 ] == 1 );
+	assert( printer_counters.sink_calls[ stats_type::SINK_STREAM ] == 1 );
+#endif
+}
+
+
+/// Tests capturing of values into a corpus file, and reading it back.
+void test_value_capture()
+{
+	typedef ml::printers::value_capture capture_type;
+	const char* path = "lr_printers_test_corpus.tmp";
+	const int site = capture_type::get_site_id( "test_site" );
+	assert( capture_type::open( path ) );
+	assert( capture_type::is_enabled() );
+	const int other_site = capture_type::get_site_id( "other_site" );
+	capture_type::capture( site, 0, 10 );
+	capture_type::capture( site, std::numeric_limits< long long >::min(), 10 );
+	capture_type::capture( other_site, std::numeric_limits< uint64_t >::max(), 36 );
+	std::thread( [site]() { capture_type::capture( site, (short)-300, 16 ); } ).join();
+#if defined( ML_PRINTERS_CAPTURE )
+	ml::printers::lr_printer_2_digits< int > p;
+	char buf[ 64 + 7 ];
+	p.print( 12'345, buf );
+#endif
+	capture_type::close();
+	assert( ! capture_type::is_enabled() );
+	capture_type::capture( site, 1, 10 );  // Not captured, as closed
+	ml::printers::corpus c;
+	assert( ml::printers::read_corpus( path, c ) );
+	assert( c.sites.size() >= 2 );
+	assert( c.sites[ site ] == "test_site" && c.sites[ other_site ] == "other_site" );
+	std::vector< ml::printers::corpus_entry > entries = c.entries;
+#if defined( ML_PRINTERS_CAPTURE )
+	assert( entries.size() == 5 );
+	assert( c.sites[ entries.back().site ] == "lr_printer_2_digits" );
+	assert( entries.back().magnitude == 12'345 );
+	entries.pop_back();
+#endif
+	assert( entries.size() == 4 );
+	// The other thread's values are written on its exit, so before ours
+	assert( entries[ 0 ].magnitude == 300 && entries[ 0 ].negative );
+	assert( entries[ 0 ].base == 16 );
+	assert( entries[ 1 ].magnitude == 0 && ! entries[ 1 ].negative );
+	assert( entries[ 2 ].magnitude == (uint64_t)1 << 63 && entries[ 2 ].negative );
+	assert( entries[ 3 ].site == other_site && entries[ 3 ].base == 36 );
+	assert( entries[ 3 ].magnitude == std::numeric_limits< uint64_t >::max() );
+	// Sampling
+	assert( capture_type::open( path, 10 ) );
+	for ( int i = 0; i < 1'000; ++i )
+		capture_type::capture( site, i, 10 );
+	capture_type::close();
+	assert( ml::printers::read_corpus( path, c ) );
+	assert( c.entries.size() == 100 );
+	std::remove( path );
+	assert( ! ml::printers::read_corpus( path, c ) );
+}
+
+
+/// Tests printing by the memoizing printer, and its counters.
+void test_memoizing_printer()
+{
+	typedef ml::printers::memoizing_printer< long long, 4 > printer_type;
+	printer_type printer;
+	char buf[ printer_type::BUFFER_SIZE_MIN ];
+	assert( printer.print( 404, buf ) == 3 );
+	assert( buf == std::string( "404" ) );
+	assert( printer.get_hits() == 0 && printer.get_misses() == 1 );
+	assert( printer.print( 404, buf ) == 3 );
+	assert( buf == std::string( "404" ) );
+	assert( printer.get_hits() == 1 && printer.get_misses() == 1 );
+	// Many more distinct values than entries: slots get replaced
+	std::mt19937_64 generator( 67 );
+	for ( int i = 0; i < 10'000; ++i ) {
+		const long long x = (long long)(generator() >> (1 + generator() % 63)) % 100;
+		printer.print( x, buf );
+		assert( buf == std::to_string( x ) );
+	}
+	assert( printer.get_hits() + printer.get_misses() == 10'002 );
+	assert( printer.get_hits() > 0 && printer.get_misses() > 16 );
+	// Texts longer than an entry aren't cached
+	printer.reset_counters();
+	printer.set_base( 2 );
+	for ( int i = 0; i < 2; ++i ) {
+		assert( printer.print( std::numeric_limits< long long >::max(), buf ) == 63 );
+		assert( buf == std::string( 63, '1' ) );
+	}
+	assert( printer.get_hits() == 0 && printer.get_misses() == 2 );
+	// Texts of up to 16 characters are cached, longer ones aren't
+	printer.set_base( 10 );
+	printer.reset_counters();
+	for ( int i = 0; i < 2; ++i ) {
+		assert( printer.print( 1'234'567'890'123'456LL, buf ) == 16 );
+		assert( buf == std::string( "1234567890123456" ) );
+		assert( printer.print( 12'345'678'901'234'567LL, buf ) == 17 );
+		assert( buf == std::string( "12345678901234567" ) );
+	}
+	assert( printer.get_hits() == 1 && printer.get_misses() == 3 );
+	printer.set_base( 2 );
+	printer.reset_counters();
+	std::ostringstream ostr;
+	printer.print( 5, ostr );
+	printer.print( 5, ostr );
+	assert( ostr.str() == "101101" );
+	assert( printer.get_hits() == 1 );
+}
+
+
+/// Tests the C interface.
+void test_c_interface()
+{
+	using namespace std::string_literals;
+	assert( lrp_create( 1, nullptr ) == nullptr );
+	assert( lrp_create( 37, nullptr ) == nullptr );
+	assert( lrp_create( 16, "0123456789" ) == nullptr );
+	lrp_printer* printer = lrp_create( 10, nullptr );
+	assert( printer != nullptr );
+	assert( lrp_max_chars( printer ) == 21 );
+	char buf[ 64 ];
+	assert( lrp_to_chars_u64( printer, 18'446'744'073'709'551'615ULL, buf, sizeof( buf ) ) == 20 );
+	assert( std::string( buf, 20 ) == "18446744073709551615" );
+	assert( lrp_to_chars_i64( printer, std::numeric_limits< int64_t >::min(), buf, 20 ) == 20 );
+	assert( std::string( buf, 20 ) == "-9223372036854775808" );
+	assert( lrp_to_chars_u64( printer, 12'345, buf, 4 ) == -1 );
+	assert( lrp_to_chars_u64( printer, 12'345, buf, 5 ) == 5 );
+	// Arrays, also longer than one batch
+	const std::vector< long long > nums = generate_mixed_lengths< long long >( 10'000, 18 );
+	std::vector< uint64_t > unsigned_nums( nums.begin(), nums.end() );
+	unsigned_nums.push_back( std::numeric_limits< uint64_t >::max() );
+	std::vector< int64_t > signed_nums( nums.begin(), nums.end() );
+	for ( size_t i = 0; i < signed_nums.size(); i += 3 )
+		signed_nums[ i ] = -signed_nums[ i ];
+	std::string expected_unsigned, expected_signed;
+	for ( uint64_t num : unsigned_nums )
+		expected_unsigned += std::to_string( num ) + ' ';
+	for ( int64_t num : signed_nums )
+		expected_signed += std::to_string( num ) + ' ';
+	std::vector< char > out( expected_unsigned.length() );
+	assert( lrp_print_u64_array( printer, unsigned_nums.data(), unsigned_nums.size(), 
+			' ', out.data(), out.size() ) == (ptrdiff_t)out.size() );
+	assert( std::string( out.begin(), out.end() ) == expected_unsigned );
+	assert( lrp_print_u64_array( printer, unsigned_nums.data(), unsigned_nums.size(), 
+			' ', out.data(), out.size() - 1 ) == -1 );
+	out.resize( expected_signed.length() );
+	assert( lrp_print_i64_array( printer, signed_nums.data(), signed_nums.size(), 
+			' ', out.data(), out.size() ) == (ptrdiff_t)out.size() );
+	assert( std::string( out.begin(), out.end() ) == expected_signed );
+	lrp_destroy( printer );
+	// Custom alphabets, bases above 16
+	printer = lrp_create( 16, "0123456789ABCDEF" );
+	const uint64_t hex_nums[] = { 0, 0xbeef, 0xc0ffee };
+	assert( lrp_print_u64_array( printer, hex_nums, 3, ',', buf, sizeof( buf ) ) == 14 );
+	assert( std::string( buf, 14 ) == "0,BEEF,C0FFEE," );
+	lrp_destroy( printer );
+	printer = lrp_create( 36, nullptr );
+	assert( lrp_print_u64_array( printer, hex_nums + 1, 2, '\n', buf, sizeof( buf ) ) == 11 );
+	assert( std::string( buf, 11 ) == "11pr\n7j3la\n" );
+	lrp_destroy( printer );
+}
+
+
+/// Tests printing of byte arrays and UUIDs in hex.
+void test_hex_printer()
+{
+	using namespace std::string_literals;
+	ml::printers::hex_printer printer;
+	ml::printers::hex_printer upper_printer;
+	upper_printer.setup_default_alphabet( true );
+	ml::printers::hex_printer custom_printer( "ABCDEFGHIJKLMNOP" );
+
+	// Digests of all lengths, crossing the 16- and 32-byte blocks
+	std::mt19937 generator( 60 );
+	std::vector< uint8_t > bytes( 100 );
+	for ( uint8_t& byte : bytes )
+		byte = (uint8_t)generator();
+	std::vector< char > buf( 2 * bytes.size() + 1 );
+	for ( size_t length = 0; length <= bytes.size(); ++length ) {
+		std::string expected, expected_upper, expected_custom;
+		for ( size_t i = 0; i < length; ++i ) {
+			char pair[ 3 ];
+			snprintf( pair, sizeof( pair ), "%02x", bytes[ i ] );
+			expected += pair;
+			snprintf( pair, sizeof( pair ), "%02X", bytes[ i ] );
+			expected_upper += pair;
+			expected_custom += (char)('A' + (bytes[ i ] >> 4));
+			expected_custom += (char)('A' + (bytes[ i ] & 0xf));
+		}
+		assert( printer.print( bytes.data(), length, buf.data() ) == (int)(2 * length) );
+		assert( buf.data() == expected );
+		upper_printer.print( bytes.data(), length, buf.data() );
+		assert( buf.data() == expected_upper );
+		custom_printer.print( bytes.data(), length, buf.data() );
+		assert( buf.data() == expected_custom );
+	}
+
+	// UUIDs
+	char uuid_buf[ ml::printers::hex_printer::UUID_LENGTH + 1 ];
+	const uint8_t uuid[ 16 ] = { 0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3,
+			0xa4, 0x56, 0x42, 0x66, 0x14, 0x17, 0x40, 0x00 };
+	assert( printer.print_uuid( uuid, uuid_buf ) == 36 );
+	assert( uuid_buf == "123e4567-e89b-12d3-a456-426614174000"s );
+	upper_printer.print_uuid( uuid, uuid_buf );
+	assert( uuid_buf == "123E4567-E89B-12D3-A456-426614174000"s );
+	for ( size_t offset = 0; offset + 16 <= bytes.size(); ++offset ) {
+		printer.print_uuid( bytes.data() + offset, uuid_buf );
+		printer.print( bytes.data() + offset, 16, buf.data() );
+		const std::string hex( buf.data() );
+		assert( uuid_buf == hex.substr( 0, 8 ) + "-" + hex.substr( 8, 4 ) + "-"
+				+ hex.substr( 12, 4 ) + "-" + hex.substr( 16, 4 ) + "-" + hex.substr( 20 ) );
+	}
+}
+
+
 /// The clock-type, used to measure performance.
 typedef std::chrono::high_resolution_clock clock_type;
 
@@ -83,9 +1207,160 @@ clock_type::duration run_printer( PrinterType& p,
 	return dur;
 }
 
+/// Evicts 'size' bytes at 'data' from all levels of data cache (where that 
+/// is supported).
+void evict_from_caches( const void* data, size_t size )
+{
+#if defined( __SSE2__ ) || defined( _M_X64 )
+	const size_t line_size = 64;
+	const char* ptr = (const char*)((uintptr_t)data & ~(uintptr_t)(line_size - 1));
+	for ( ; ptr < (const char*)data + size; ptr += line_size )
+		_mm_clflush( ptr );
+	_mm_mfence();
+#else
+	(void)data;
+	(void)size;
+#endif
+}
+
+/// Invokes provided printer on printing numbers of 'nums', evicting memory 
+/// regions 'evicted' from the caches before every number. Measures and 
+/// returns average time of printing one number.
+template< typename PrinterType, typename NumberType >
+clock_type::duration run_printer_cold_data( PrinterType& p, 
+		const std::vector< NumberType >& nums, 
+		const std::vector< std::pair< const void*, size_t > >& evicted, char* buf )
+{
+	clock_type::duration dur( 0 );
+	for ( NumberType num : nums ) {
+		for ( const auto& region : evicted )
+			evict_from_caches( region.first, region.second );
+		clock_type::time_point start_time = clock_type::now();
+		p.print( num, buf );
+		dur += clock_type::now() - start_time;
+	}
+	dur /= nums.size();
+	std::cout << std::chrono::duration_cast< std::chrono::nanoseconds >( dur ).count()
+			<< " ns" << std::endl;
+	return dur;
+}
+
+/// Pieces of code, which are executed in order to evict printers' code from 
+/// the instruction cache. Every piece is a distinct function.
+template< int I >
+ML_PRINTERS_NOINLINE void run_code_piece( volatile unsigned& state )
+	{ state = state * (2 * I + 1) + I;
+	  state = state ^ (state >> (I % 13 + 1)); }
+
+template< int... Is >
+void run_code_pieces( volatile unsigned& state, std::integer_sequence< int, Is... > )
+	{ const int dummy[] = { (run_code_piece< Is >( state ), 0)... };
+	  (void)dummy; }
+
+/// Prints one number of each of several integer types by the printers 
+/// 'PrinterTemplate', every time after running code, which is much larger 
+/// than the instruction cache. Measures and returns average time of that 
+/// printing.
+template< template< typename... > class PrinterTemplate >
+clock_type::duration run_printers_cold( int rounds, char* buf )
+{
+	const PrinterTemplate< unsigned char > char_printer;
+	const PrinterTemplate< unsigned short > short_printer;
+	const PrinterTemplate< int > int_printer;
+	const PrinterTemplate< unsigned long long > long_printer;
+	volatile unsigned state = 0;
+	clock_type::duration dur( 0 );
+	for ( int i = 0; i < rounds; ++i ) {
+		run_code_pieces( state, std::make_integer_sequence< int, 2'048 >() );
+		const unsigned x = state;
+		clock_type::time_point start_time = clock_type::now();
+		char* ptr = buf;
+		ptr += char_printer.print( (unsigned char)x, ptr );
+		ptr += short_printer.print( (unsigned short)x, ptr );
+		ptr += int_printer.print( (int)(x >> 1), ptr );
+		long_printer.print( (unsigned long long)x * x, ptr );
+		dur += clock_type::now() - start_time;
+	}
+	dur /= rounds;
+	std::cout << std::chrono::duration_cast< std::chrono::nanoseconds >( dur ).count()
+			<< " ns" << std::endl;
+	return dur;
+}
+
+/// Adapts the C interface to interfaces of the printers, so it can be 
+/// benchmarked the same way.
+class c_interface_printer
+{
+protected:
+	lrp_printer* _printer;
+
+public:
+	explicit c_interface_printer( int base )
+		: _printer( lrp_create( base, nullptr ) )
+		{}
+	c_interface_printer( const c_interface_printer& ) = delete;
+	~c_interface_printer()
+		{ lrp_destroy( _printer ); }
+
+	int print( uint64_t x, char* buf ) const
+		{ const int length = lrp_to_chars_u64( _printer, x, buf, 64 );
+		  buf[ length ] = '\0';
+		  return length; }
+
+	size_t print( const uint64_t* nums, size_t count, char* buf, char separator ) const
+		{ return (size_t)lrp_print_u64_array( _printer, nums, count, separator, 
+				buf, count * (lrp_max_chars( _printer ) + 1) ); }
+	size_t print( const int64_t* nums, size_t count, char* buf, char separator ) const
+		{ return (size_t)lrp_print_i64_array( _printer, nums, count, separator, 
+				buf, count * (lrp_max_chars( _printer ) + 1) ); }
+};
+
+/// Invokes provided printer on printing all numbers of 'nums', one by one 
+/// and separated by new-lines, into a large buffer. Measures and returns 
+/// time required for that.
+template< typename PrinterType, typename NumberType >
+clock_type::duration run_printer_on_values( PrinterType& p, 
+		const std::vector< NumberType >& nums, std::vector< char >& out )
+{
+	clock_type::time_point start_time = clock_type::now();
+	// Printing
+	char* ptr = out.data();
+	for ( NumberType num : nums ) {
+		ptr += p.print( num, ptr );
+		*(ptr++) = '\n';
+	}
+	clock_type::duration dur = clock_type::now() - start_time;
+	std::cout << std::chrono::duration_cast< std::chrono::milliseconds >( dur ).count()
+			<< " msc" << std::endl;
+	return dur;
+}
+
+/// Invokes provided batch printer on printing all numbers of 'nums', 
+/// separated by new-lines, into a large buffer. Measures and returns time 
+/// required for that.
+template< typename PrinterType, typename NumberType >
+clock_type::duration run_batch_printer_on_values( PrinterType& p, 
+		const std::vector< NumberType >& nums, std::vector< char >& out )
+{
+	clock_type::time_point start_time = clock_type::now();
+	// Printing
+	const size_t batch_size = 4'096;
+	char* ptr = out.data();
+	for ( size_t i = 0; i < nums.size(); i += batch_size )
+		ptr += p.print( nums.data() + i, std::min( batch_size, nums.size() - i ), 
+				ptr, '\n' );
+	clock_type::duration dur = clock_type::now() - start_time;
+	std::cout << std::chrono::duration_cast< std::chrono::milliseconds >( dur ).count()
+			<< " msc" << std::endl;
+	return dur;
+}
+
 
 int main( int argc, char* argv[] )
 {
+	// With "--tests-only" the benchmarks are skipped
+	const bool tests_only = argc > 1 && std::string( argv[ 1 ] ) == "--tests-only";
+
 	// Testing "modulo printer"
 	std::cout << "Modulo printer:" << std::endl;
 
@@ -114,6 +1389,9 @@ int main( int argc, char* argv[] )
 		std::cout << "\t Testing 'lr_printer< long long >' ..." << std::endl;
 		ml::printers::lr_printer< long long > printer;
 		test_printer( printer );
+		test_digit_range< int >();
+		test_digit_range< long long >();
+		test_base_switching( printer );
 	}
 
 	{
@@ -126,8 +1404,228 @@ int main( int argc, char* argv[] )
 		std::cout << "\t Testing 'lr_printer_2_digits< long long >' ..." << std::endl;
 		ml::printers::lr_printer_2_digits< long long > printer;
 		test_printer( printer );
+		test_base_switching( printer );
+		// Custom alphabet must survive switching the base, and copying
+		using namespace std::string_literals;
+		char buf[ 25 ];
+		printer.set_alphabet( "ABCDEFGHIJKLMNOP" );
+		printer.set_base( 16 );
+		ml::printers::lr_printer_2_digits< long long > printer_copy = printer;
+		printer.setup_default_alphabet();
+		printer_copy.print( 0xBEEF, buf );
+		assert( buf == "LOOP"s );
+		printer.print( 0xBEEF, buf );
+		assert( buf == "beef"s );
+	}
+
+	{
+		std::cout << "\t Testing 'lr_printer_batch< int >' ..." << std::endl;
+		ml::printers::lr_printer_batch< int > printer;
+		test_printer( printer );
+		test_batch_printer< int >( 10 );
+		test_batch_printer< int >( 2 );
+	}
+
+	{
+		std::cout << "\t Testing 'lr_printer_batch< long long >' ..." << std::endl;
+		ml::printers::lr_printer_batch< long long > printer;
+		test_printer( printer );
+		test_batch_printer< long long >( 10 );
+		test_batch_printer< long long >( 16 );
+		test_batch_printer< long long >( 2 );
+	}
+
+	{
+		std::cout << "\t Testing 'lr_printer_translated< long long >' ..." << std::endl;
+		ml::printers::lr_printer_translated< long long > printer;
+		test_printer( printer );
+		test_base_switching( printer );
+		test_translated_printer< int >();
+		test_translated_printer< long long >();
+	}
+
+	{
+		std::cout << "\t Testing 'lr_printer_utf8< long long >' ..." << std::endl;
+		ml::printers::lr_printer_utf8< long long > printer;
+		test_printer( printer );
+		test_base_switching( printer );
+		test_utf8_printer< int >();
+		test_utf8_printer< long long >();
+	}
+
+	{
+		std::cout << "\t Testing 'lean_printer' ..." << std::endl;
+		ml::printers::lean_printer< int > printer;
+		test_printer( printer );
+		test_base_switching( printer );
+		ml::printers::lean_printer< unsigned long long > long_printer;
+		test_base_switching( long_printer );
+		ml::printers::lean_printer< unsigned char > byte_printer( 16, "0123456789ABCDEF" );
+		char buf[ 8 ];
+		byte_printer.print( (unsigned char)0xaf, buf );
+		assert( buf == std::string( "AF" ) );
+	}
+
+	{
+		std::cout << "\t Testing 'table_free_printer' ..." << std::endl;
+		test_table_free_printer< int, 10 >();
+		test_table_free_printer< unsigned, 2 >();
+		test_table_free_printer< long long, 10 >();
+		test_table_free_printer< unsigned long long, 10 >();
+		test_table_free_printer< unsigned long long, 16 >();
+		test_table_free_printer< long long, 36 >();
+		test_table_free_printer< unsigned short, 7 >();
+		test_table_free_printer< unsigned char, 10 >();
+		test_table_free_printer< unsigned char, 16 >();
+		test_table_free_printer< signed char, 16 >();
+		test_table_free_printer< unsigned char, 36 >();
+		test_table_free_printer< signed char, 36 >();
+	}
+
+	{
+		std::cout << "\t Testing printing in constant expressions ..." << std::endl;
+		test_constexpr_printing();
+	}
+
+	{
+		std::cout << "\t Testing 'composed_printer' ..." << std::endl;
+		using namespace ml::printers;
+		test_composed_printer< modulo_engine, constexpr_table_policy< char > >();
+		test_composed_printer< modulo_2_digits_engine, constexpr_table_policy< char > >();
+		test_composed_printer< lr_engine, constexpr_table_policy< char > >();
+		test_composed_printer< lr_2_digits_engine, constexpr_table_policy< char > >();
+		test_composed_printer< lr_2_digits_engine, inline_table_policy< char > >();
+		test_composed_printer< lr_2_digits_engine, shared_table_policy< char > >();
+		test_composed_printer< lr_k_digits_engine< 3 >, inline_table_policy< char > >();
+		test_composed_printer< lr_k_digits_engine< 4 >, constexpr_table_policy< char > >();
+		test_composed_printer_8_bit< modulo_engine >();
+		test_composed_printer_8_bit< modulo_2_digits_engine >();
+		test_composed_printer_8_bit< lr_engine >();
+		test_composed_printer_8_bit< lr_2_digits_engine >();
+		test_composed_printer_8_bit< lr_k_digits_engine< 3 > >();
+		test_composed_printer_8_bit< lr_k_digits_engine< 4 > >();
+		test_composed_printer_copy< inline_table_policy< char > >();
+		test_composed_printer_copy< shared_table_policy< char > >();
+		// Custom alphabets
+		composed_printer< unsigned, modulo_2_digits_engine, shared_table_policy< char > > 
+				printer( 16, "0123456789ABCDEF" );
+		char buf[ 32 ];
+		printer.print( 0xbeefu, buf );
+		assert( buf == std::string( "BEEF" ) );
+		composed_printer< unsigned, lr_k_digits_engine< 4 >, inline_table_policy< wchar_t > > 
+				wide_printer( 16, L"0123456789ABCDEF" );
+		wchar_t wide_buf[ 32 ];
+		wide_printer.print( 0xc0ffeeu, wide_buf );
+		assert( wide_buf == std::wstring( L"C0FFEE" ) );
+		// Printing to a sink
+		std::string str;
+		printer.setup_default_alphabet();
+		assert( printer.print_to_sink( 0xcafeu, string_sink( str ) ) == 4 );
+		assert( str == "cafe" );
+	}
+
+	{
+		std::cout << "\t Testing printers of 'wchar_t', 'char16_t' and 'char32_t' ..." << std::endl;
+		test_wide_printer< ml::printers::modulo_printer, wchar_t >();
+		test_wide_printer< ml::printers::modulo_printer_2_digits, char16_t >();
+		test_wide_printer< ml::printers::lr_printer, char32_t >();
+		test_wide_printer< ml::printers::lr_printer_2_digits, wchar_t >();
+		test_wide_printer< ml::printers::lr_printer_2_digits, char16_t >();
+		test_wide_printer< ml::printers::lr_printer_2_digits, char32_t >();
+		// Printing to wide streams
+		ml::printers::lr_printer_2_digits< int, wchar_t > printer;
+		std::wostringstream ostr;
+		printer.print( 123, ostr );
+		ostr << L" ";
+		printer.print( 0, ostr );
+		assert( ostr.str() == L"123 0" );
+	}
+
+	// Testing printers of special values
+	std::cout << "Special printers:" << std::endl;
+
+	{
+		std::cout << "\t Testing address printers ..." << std::endl;
+		test_address_printers();
+	}
+
+	{
+		std::cout << "\t Testing C interface ..." << std::endl;
+		test_c_interface();
+	}
+
+	{
+		std::cout << "\t Testing check digit printers ..." << std::endl;
+		test_check_digit_printers();
+	}
+
+	{
+		std::cout << "\t Testing 'hex_printer' ..." << std::endl;
+		test_hex_printer();
+	}
+
+	{
+		std::cout << "\t Testing 'memoizing_printer' ..." << std::endl;
+		test_memoizing_printer();
+	}
+
+	{
+		std::cout << "\t Testing 'mixed_radix_printer' ..." << std::endl;
+		test_mixed_radix_printer();
+	}
+
+	{
+		std::cout << "\t Testing 'printer_stats' ..." << std::endl;
+		test_printer_stats();
+	}
+
+	{
+		std::cout << "\t Testing 'value_capture' ..." << std::endl;
+		test_value_capture();
+	}
+
+	{
+		std::cout << "\t Testing 'timestamp_printer' ..." << std::endl;
+		test_timestamp_printer();
+	}
+
+	// Testing writers of textual formats
+	std::cout << "Writers:" << std::endl;
+
+	{
+		std::cout << "\t Testing field printers ..." << std::endl;
+		test_field_printers();
+	}
+
+	{
+		std::cout << "\t Testing 'record_writer' ..." << std::endl;
+		test_record_writer();
 	}
 
+	{
+		std::cout << "\t Testing 'string_column_builder' ..." << std::endl;
+		test_string_column_builder< int32_t >( 1 );
+		test_string_column_builder< int64_t >( 4 );
+	}
+
+	{
+		std::cout << "\t Testing 'json_writer' ..." << std::endl;
+		test_json_writer();
+	}
+
+	{
+		std::cout << "\t Testing 'metrics_writer' ..." << std::endl;
+		test_metrics_writer();
+	}
+
+	{
+		std::cout << "\t Testing 'resp_encoder' ..." << std::endl;
+		test_resp_encoder();
+	}
+
+	if ( tests_only )
+		return 0;
+
 	{
 		// Compare printers' performance
 		typedef int number_type;
@@ -190,6 +1688,194 @@ int main( int argc, char* argv[] )
 			ml::printers::lr_printer_2_digits< number_type > printer;
 			run_printer( printer, start_num, finish_num );
 		}
+		{
+			std::cout << "\t lr_printer_translated: ";
+			ml::printers::lr_printer_translated< number_type > printer;
+			run_printer( printer, start_num, finish_num );
+		}
+	}
+
+	{
+		// Compare printers with obfuscated alphabets of bases 32 and 36, which 
+		// the translated printer translates by 3 shuffles (instead of 1 for 
+		// up to 16 characters). 'lr_printer_2_digits' supports custom 
+		// alphabets only up to base 17, so the same algorithm is taken from 
+		// the composed printer, with pairs of the custom alphabet.
+		typedef long long number_type;
+		const number_type 
+				start_num = 52'109'000'000'000'000LL, 
+				finish_num = 52'109'000'049'000'000LL;
+		const std::string alphabet = "o413s78l9x6hjqzngrw5uec2tyf0mpaikdbv";
+		for ( short base : { 32, 36 } ) {
+			std::cout << "Running the printers on numbers in ["
+					<< start_num << ", " << finish_num << "], 64-bit, with base=" 
+					<< base << " and a custom alphabet:" << std::endl;
+			{
+				std::cout << "\t composed_printer< lr_2_digits, inline >: ";
+				ml::printers::composed_printer< number_type, 
+						ml::printers::lr_2_digits_engine, 
+						ml::printers::inline_table_policy< char > > printer( 
+								base, alphabet );
+				run_printer( printer, start_num, finish_num );
+			}
+			{
+				std::cout << "\t lr_printer_translated: ";
+				ml::printers::lr_printer_translated< number_type > printer( base, alphabet );
+				run_printer( printer, start_num, finish_num );
+			}
+			{
+				std::cout << "\t lr_printer_translated (default alphabet): ";
+				ml::printers::lr_printer_translated< number_type > printer( base );
+				run_printer( printer, start_num, finish_num );
+			}
+		}
+	}
+
+	{
+		// Compare printers' performance on numbers of randomly mixed lengths
+		typedef long long number_type;
+				// Run on 64-bit integers
+		const int max_digits = 18;
+		const std::vector< number_type > nums = 
+				generate_mixed_lengths< number_type >( 20'000'000, max_digits );
+		std::vector< char > out( nums.size() * (max_digits + 1) );
+		std::cout << "Running the printers on " << nums.size() 
+				<< " numbers with 1 to " << max_digits << " digits, 64-bit, with base=10:" << std::endl;
+
+		{
+			std::cout << "\t modulo_printer_2_digits: ";
+			ml::printers::modulo_printer_2_digits< number_type > printer;
+			run_printer_on_values( printer, nums, out );
+		}
+		{
+			std::cout << "\t lr_printer_2_digits: ";
+			ml::printers::lr_printer_2_digits< number_type > printer;
+			run_printer_on_values( printer, nums, out );
+		}
+		{
+			std::cout << "\t lr_printer_batch: ";
+			ml::printers::lr_printer_batch< number_type > printer;
+			run_batch_printer_on_values( printer, nums, out );
+		}
+		{
+			std::cout << "\t composed_printer< modulo_2_digits, constexpr >: ";
+			ml::printers::composed_printer< number_type, 
+					ml::printers::modulo_2_digits_engine > printer;
+			run_printer_on_values( printer, nums, out );
+		}
+		{
+			std::cout << "\t composed_printer< lr_2_digits, constexpr >: ";
+			ml::printers::composed_printer< number_type, 
+					ml::printers::lr_2_digits_engine > printer;
+			run_printer_on_values( printer, nums, out );
+		}
+		{
+			std::cout << "\t composed_printer< lr_2_digits, inline >: ";
+			ml::printers::composed_printer< number_type, 
+					ml::printers::lr_2_digits_engine, 
+					ml::printers::inline_table_policy< char > > printer;
+			run_printer_on_values( printer, nums, out );
+		}
+		{
+			std::cout << "\t composed_printer< lr_k_digits< 4 >, constexpr >: ";
+			ml::printers::composed_printer< number_type, 
+					ml::printers::lr_k_digits_engine< 4 > > printer;
+			run_printer_on_values( printer, nums, out );
+		}
+		{
+			std::cout << "\t table_free_printer: ";
+			ml::printers::table_free_printer< number_type > printer;
+			run_printer_on_values( printer, nums, out );
+		}
+		{
+			// Through the C interface, as other languages call it
+			const std::vector< uint64_t > unsigned_nums( nums.begin(), nums.end() );
+			c_interface_printer printer( 10 );
+			std::cout << "\t lrp_to_chars_u64 (C interface, per number): ";
+			run_printer_on_values( printer, unsigned_nums, out );
+			std::cout << "\t lrp_print_u64_array (C interface, per array): ";
+			run_batch_printer_on_values( printer, unsigned_nums, out );
+			// Signed arrays are printed value by value, so this shows the 
+			// gain of the batch printer behind 'lrp_print_u64_array()'
+			const std::vector< int64_t > signed_nums( nums.begin(), nums.end() );
+			std::cout << "\t lrp_print_i64_array (C interface, per array, value by value): ";
+			run_batch_printer_on_values( printer, signed_nums, out );
+		}
+	}
+
+	{
+		// Compare printers' performance when their tables are not in the 
+		// data caches, as it happens when printing is rare
+		typedef long long number_type;
+		const std::vector< number_type > nums = 
+				generate_mixed_lengths< number_type >( 100'000, 18 );
+		ml::printers::lr_printer_2_digits< number_type > printer;
+		ml::printers::table_free_printer< number_type > table_free_printer;
+		// The same regions are evicted for both printers: the tables, and 
+		// the printers themselves
+		const std::vector< std::pair< const void*, size_t > > evicted = {
+				{ ml::printers::get_precomputed_powers< number_type >( 10 ), 
+					ml::printers::get_precomputed_powers_length< number_type >( 10 ) 
+						* sizeof( number_type ) }, 
+				{ ml::printers::get_precomputed_default_pairs< char >( 10 ), 2 * 10 * 10 }, 
+				{ &printer, sizeof( printer ) }, 
+				{ &table_free_printer, sizeof( table_free_printer ) } };
+		std::cout << "Running the printers on " << nums.size() 
+				<< " numbers with 1 to 18 digits, 64-bit, with base=10, with cold data caches:" 
+				<< std::endl;
+
+		{
+			std::cout << "\t lr_printer_2_digits: ";
+			run_printer_cold_data( printer, nums, evicted, buf );
+		}
+		{
+			std::cout << "\t table_free_printer: ";
+			run_printer_cold_data( table_free_printer, nums, evicted, buf );
+		}
+	}
+
+	{
+		// Compare printers' performance when their code is not in the 
+		// instruction cache, as it happens in large programs
+		const int rounds = 20'000;
+		std::cout << "Running the printers " << rounds 
+				<< " times on 4 integer types, with cold instruction cache:" << std::endl;
+
+		{
+			std::cout << "\t lr_printer_2_digits: ";
+			run_printers_cold< ml::printers::lr_printer_2_digits >( rounds, buf );
+		}
+		{
+			std::cout << "\t lean_printer: ";
+			run_printers_cold< ml::printers::lean_printer >( rounds, buf );
+		}
+	}
+
+	{
+		// Compare printers' performance on few distinct values, as HTTP 
+		// statuses or shard identifiers are
+		typedef unsigned number_type;
+		const number_type statuses[] = { 200, 200, 200, 200, 201, 204, 301, 304, 
+				400, 401, 403, 404, 404, 429, 500, 502, 503 };
+		std::mt19937 generator( 67 );
+		std::vector< number_type > nums( 20'000'000 );
+		for ( number_type& num : nums )
+			num = statuses[ generator() % (sizeof( statuses ) / sizeof( statuses[ 0 ] )) ];
+		typedef ml::printers::memoizing_printer< number_type > memoizing_type;
+		std::vector< char > out( nums.size() * 4 + memoizing_type::BUFFER_SIZE_MIN );
+		std::cout << "Running the printers on " << nums.size() 
+				<< " HTTP statuses, 32-bit, with base=10:" << std::endl;
+
+		{
+			std::cout << "\t lr_printer_2_digits: ";
+			ml::printers::lr_printer_2_digits< number_type > printer;
+			run_printer_on_values( printer, nums, out );
+		}
+		{
+			std::cout << "\t memoizing_printer: ";
+			memoizing_type printer;
+			run_printer_on_values( printer, nums, out );
+		}
 	}
 
 	std::cout << "Last converted number (to prevent unnecessary optimizations): " 
@@ -0,0 +1,181 @@
+
+#ifndef ML__PRINTERS__MEMOIZING_PRINTER_HPP
+#define ML__PRINTERS__MEMOIZING_PRINTER_HPP
+
+#include <vector>
+#include <ostream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#include "lr_printer_2_digits.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This printer remembers texts of recently printed numbers in a small
+/// direct-mapped cache, so streams with few distinct values (statuses,
+/// shard identifiers, enumeration-like codes) are printed by one probe
+/// and one fixed-size copy. Numbers which are not in the cache are printed
+/// by 'lr_printer_2_digits', and replace the previous entry of their slot.
+/// Counts of hits and misses are collected, in order to tell if the cache
+/// pays off on the given data.
+/// Texts are copied with fixed size, so buffers passed for printing must
+/// have at least 'BUFFER_SIZE_MIN' characters.
+template< typename NumberType, short CacheSizeLog = 10 >
+class memoizing_printer
+{
+public:
+	typedef NumberType number_type;
+	typedef memoizing_printer< NumberType, CacheSizeLog > this_type;
+
+	/// Count of entries in the cache.
+	static constexpr size_t CACHE_SIZE = (size_t)1 << CacheSizeLog;
+
+protected:
+	/// Size of every entry, so the cache of 1024 entries fits in 32KB of
+	/// L1 data cache.
+	static constexpr size_t ENTRY_SIZE = 32;
+
+	/// Size of the text slot of an entry, which is copied as a whole on a
+	/// hit. It holds decimal numbers of up to 16 digits; longer texts are
+	/// never cached.
+	static constexpr int TEXT_SLOT_SIZE = 16;
+
+	/// Maximal count of digits, printed on a miss.
+	/// Assuming printing 64-bit number in base 2, with a bit more digits.
+	static constexpr int DIGITS_MAX = 64 + 5;
+
+public:
+	/// Minimal size of buffers, passed for printing: room for the longest
+	/// number (printed on a miss), for the fixed-size copy (on a hit), and
+	/// for the null-character.
+	static constexpr int BUFFER_SIZE_MIN
+			= (DIGITS_MAX > TEXT_SLOT_SIZE ? DIGITS_MAX : TEXT_SLOT_SIZE) + 1;
+
+protected:
+	static_assert( sizeof( number_type ) + 1 + TEXT_SLOT_SIZE <= ENTRY_SIZE,
+			"Entries must have room for the number and its text." );
+
+	/// Entry of the cache. The text slot comes first, so it is aligned
+	/// for the fixed-size copy.
+	struct entry {
+		/// Text of the number, padded to 'TEXT_SLOT_SIZE' characters.
+		char text[ TEXT_SLOT_SIZE ];
+
+		/// The cached number.
+		number_type value;
+
+		/// Length of the text. 0 marks an empty entry.
+		unsigned char length;
+
+		/// Padding up to 'ENTRY_SIZE'.
+		char padding[ ENTRY_SIZE - TEXT_SLOT_SIZE - sizeof( number_type ) - 1 ];
+	};
+
+	static_assert( sizeof( entry ) == ENTRY_SIZE,
+			"Entries must have size of 'ENTRY_SIZE'." );
+
+	/// The cache. It is filled while printing, so it is mutable.
+	mutable std::vector< entry > _entries;
+
+	/// Printer of numbers, missing in the cache.
+	lr_printer_2_digits< number_type > _printer;
+
+	/// Counts of hits and misses.
+	mutable size_t _hits = 0;
+	mutable size_t _misses = 0;
+
+	/// The buffer to hold the text, before sending it to output stream or
+	/// output file.
+	mutable char _buffer[ BUFFER_SIZE_MIN ];
+
+protected:
+	/// Returns index of entry of 'x': upper bits of its product with the
+	/// golden ratio (Fibonacci hashing), so that regular sequences of values
+	/// are spread over the whole cache.
+	static size_t get_slot( const number_type& x )
+		{ return (size_t)(((uint64_t)x * 0x9e3779b97f4a7c15ULL) >> (64 - CacheSizeLog)); }
+
+	/// This is the base printing routine.
+	/// Returns pointer past the last printed character.
+	char* print_to( const number_type& x, char* out ) const {
+		entry& e = _entries[ get_slot( x ) ];
+		if ( e.value == x && e.length != 0 ) {
+			++_hits;
+			memcpy( out, e.text, TEXT_SLOT_SIZE );
+			return out + e.length;
+		}
+		++_misses;
+		char* end = _printer.print_digits( x, out );
+		const int length = (int)(end - out);
+		if ( length <= TEXT_SLOT_SIZE ) {
+			e.value = x;
+			memcpy( e.text, out, length );
+			e.length = (unsigned char)length;
+		}
+		return end;
+	}
+
+public:
+	/// Constructor with base specification.
+	explicit memoizing_printer( short base_ = 10 )
+		: _entries( CACHE_SIZE ),
+		  _printer( base_ )
+		{ clear(); }
+
+	/// Setter / getter for the base. Switching the base clears the cache.
+	void set_base( short base_ )
+		{ _printer.set_base( base_ );
+		  clear(); }
+	short get_base() const
+		{ return _printer.get_base(); }
+
+	/// Clears the cache (but not the counters).
+	void clear()
+		{ memset( _entries.data(), 0, _entries.size() * sizeof( entry ) ); }
+
+	/// Counts of numbers, found and not found in the cache.
+	size_t get_hits() const
+		{ return _hits; }
+	size_t get_misses() const
+		{ return _misses; }
+	void reset_counters()
+		{ _hits = 0;
+		  _misses = 0; }
+
+	/// Prints integer 'x' into buffer 'buf' (of at least 'BUFFER_SIZE_MIN'
+	/// characters), and appends null-character.
+	/// Returns number of digits printed (null-character not included).
+	int print( const number_type& x, char* buf ) const
+		{ char* buf_end = print_to( x, buf );
+		  *buf_end = '\0';
+		  return (int)(buf_end - buf); }
+
+	/// Prints integer 'x' into buffer 'buf' (of at least 'BUFFER_SIZE_MIN'
+	/// characters), without appending null-character.
+	/// Returns pointer past the last printed digit.
+	char* print_digits( const number_type& x, char* buf ) const
+		{ return print_to( x, buf ); }
+
+	/// Prints integer 'x' into specified file, without appending any other
+	/// character.
+	/// Returns number of digits printed.
+	int print( const number_type& x, FILE* file ) const
+		{ char* buf_end = print_to( x, _buffer );
+		  fwrite( _buffer, 1, buf_end - _buffer, file );
+		  return (int)(buf_end - _buffer); }
+
+	/// Prints integer 'x' into output stream 'ostr'.
+	std::ostream& print( const number_type& x, std::ostream& ostr ) const
+		{ char* buf_end = print_to( x, _buffer );
+		  return ostr.write( _buffer, buf_end - _buffer ); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__MEMOIZING_PRINTER_HPP
@@ -0,0 +1,230 @@
+
+#ifndef ML__PRINTERS__METRICS_WRITER_HPP
+#define ML__PRINTERS__METRICS_WRITER_HPP
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cassert>
+
+#include "field_printers.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This class writes metrics in the text exposition format of Prometheus
+/// (version 0.0.4), where timestamps are integer milliseconds. OpenMetrics
+/// (with timestamps in seconds, and the terminating '# EOF' line) is not
+/// produced.
+/// Every series is registered once, and its prefix 'name{labels} ' is
+/// formatted and stored at registration. Then during every scrape only
+/// values (and optional timestamps) are printed after the stored prefixes,
+/// into a buffer which is reused among scrapes.
+class metrics_writer
+{
+public:
+	typedef metrics_writer this_type;
+
+	/// Identifier of a registered series, or of a family header.
+	typedef size_t series_id;
+
+	/// Labels of a series, as (name, value) pairs.
+	typedef std::vector< std::pair< std::string, std::string > > labels_type;
+
+protected:
+	/// Location of a preformatted text in '_prefixes'.
+	struct text_location {
+		size_t offset;
+		size_t length;
+	};
+
+	/// Preformatted texts of all series and family headers, one after
+	/// another (so the hot ones stay close in memory).
+	std::vector< char > _prefixes;
+
+	/// Locations of preformatted prefixes of all series.
+	std::vector< text_location > _series;
+
+	/// Locations of preformatted family headers.
+	std::vector< text_location > _families;
+
+	/// The buffer, holding the text of the current scrape.
+	std::vector< char > _buffer;
+
+	/// Length of the text in '_buffer'.
+	size_t _length = 0;
+
+	/// Printer of integer values and timestamps.
+	integer_field_printer< long long > _integer_printer;
+
+	/// Printer of fixed-point values.
+	fixed_point_field_printer< long long > _fixed_point_printer;
+
+	/// Maximal length of a value, with its preceding space or line break.
+	static constexpr size_t VALUE_LENGTH_MAX
+			= 1 + fixed_point_field_printer< long long >::MAX_LENGTH;
+
+protected:
+	/// Appends 'str' to the preformatted texts, escaping the characters
+	/// which are not allowed in label values.
+	void append_escaped( const std::string& str ) {
+		for ( char ch : str ) {
+			switch ( ch ) {
+				case '\\': _prefixes.push_back( '\\' ); _prefixes.push_back( '\\' ); break;
+				case '"':  _prefixes.push_back( '\\' ); _prefixes.push_back( '"' ); break;
+				case '\n': _prefixes.push_back( '\\' ); _prefixes.push_back( 'n' ); break;
+				default:   _prefixes.push_back( ch );
+			}
+		}
+	}
+
+	/// Appends 'str' to the preformatted texts as is.
+	void append( const std::string& str )
+		{ _prefixes.insert( _prefixes.end(), str.begin(), str.end() ); }
+
+	/// Makes sure that buffer has at least 'length' free characters.
+	/// Returns pointer to where next characters must be written.
+	char* reserve( size_t length ) {
+		if ( _buffer.size() - _length < length )
+			_buffer.resize( std::max( _buffer.size() * 2, _length + length ) );
+		return _buffer.data() + _length;
+	}
+
+	/// Copies preformatted text at 'location' into the buffer, reserving
+	/// 'extra_length' more characters after it.
+	/// Returns pointer past the copied text.
+	char* print_text( const text_location& location, size_t extra_length ) {
+		char* ptr = reserve( location.length + extra_length );
+		memcpy( ptr, _prefixes.data() + location.offset, location.length );
+		return ptr + location.length;
+	}
+
+	/// Finishes a sample at 'ptr', optionally with a timestamp.
+	void finish_sample( char* ptr ) {
+		*(ptr++) = '\n';
+		_length = (size_t)(ptr - _buffer.data());
+		assert( _length <= _buffer.size() );
+	}
+	void finish_sample( char* ptr, long long timestamp ) {
+		*(ptr++) = ' ';
+		ptr = _integer_printer.print( timestamp, ptr );
+		finish_sample( ptr );
+	}
+
+public:
+	/// Constructor with specification of initial capacity of the buffer.
+	explicit metrics_writer( size_t capacity_ = 64 * 1024 )
+		: _buffer( capacity_ )
+		{}
+
+	/// Registers a metric family, with its type (e.g. "counter", "gauge")
+	/// and help text. Returns identifier of its header, which should be
+	/// written before the series of the family.
+	series_id add_family( const std::string& name, const std::string& type,
+			const std::string& help ) {
+		const size_t offset = _prefixes.size();
+		if ( ! help.empty() ) {
+			append( "# HELP " + name + " " );
+			for ( char ch : help ) {  // Only backslash and line break are escaped
+				if ( ch == '\\' || ch == '\n' ) {
+					_prefixes.push_back( '\\' );
+					_prefixes.push_back( ch == '\n' ? 'n' : '\\' );
+				}
+				else
+					_prefixes.push_back( ch );
+			}
+			_prefixes.push_back( '\n' );
+		}
+		append( "# TYPE " + name + " " + type + "\n" );
+		_families.push_back( { offset, _prefixes.size() - offset } );
+		return _families.size() - 1;
+	}
+
+	/// Registers a series with metric 'name' and 'labels'.
+	/// Returns its identifier.
+	series_id add_series( const std::string& name, const labels_type& labels = {} ) {
+		const size_t offset = _prefixes.size();
+		append( name );
+		if ( ! labels.empty() ) {
+			_prefixes.push_back( '{' );
+			for ( size_t i = 0; i < labels.size(); ++i ) {
+				if ( i > 0 )
+					_prefixes.push_back( ',' );
+				append( labels[ i ].first );
+				append( "=\"" );
+				append_escaped( labels[ i ].second );
+				_prefixes.push_back( '"' );
+			}
+			_prefixes.push_back( '}' );
+		}
+		_prefixes.push_back( ' ' );
+		_series.push_back( { offset, _prefixes.size() - offset } );
+		return _series.size() - 1;
+	}
+
+	/// Count of registered series.
+	size_t get_series_count() const
+		{ return _series.size(); }
+
+	/// Starts a new scrape, discarding text of the previous one.
+	void begin_scrape()
+		{ _length = 0; }
+
+	/// Writes header of a family.
+	void write_family( series_id id ) {
+		assert( id < _families.size() );
+		_length = (size_t)(print_text( _families[ id ], 0 ) - _buffer.data());
+	}
+
+	/// Writes an integer sample of a series, optionally with a timestamp
+	/// (in milliseconds).
+	void write( series_id id, long long value ) {
+		assert( id < _series.size() );
+		char* ptr = print_text( _series[ id ], VALUE_LENGTH_MAX );
+		finish_sample( _integer_printer.print( value, ptr ) );
+	}
+	void write( series_id id, long long value, long long timestamp ) {
+		assert( id < _series.size() );
+		char* ptr = print_text( _series[ id ], 2 * VALUE_LENGTH_MAX );
+		finish_sample( _integer_printer.print( value, ptr ), timestamp );
+	}
+
+	/// Writes a fixed-point sample of a series ('value' with 'scale' last
+	/// digits being the fractional part), optionally with a timestamp.
+	void write_fixed_point( series_id id, long long value, short scale ) {
+		assert( id < _series.size() );
+		char* ptr = print_text( _series[ id ], VALUE_LENGTH_MAX );
+		_fixed_point_printer.set_scale( scale );
+		finish_sample( _fixed_point_printer.print( value, ptr ) );
+	}
+	void write_fixed_point( series_id id, long long value, short scale,
+			long long timestamp ) {
+		assert( id < _series.size() );
+		char* ptr = print_text( _series[ id ], 2 * VALUE_LENGTH_MAX );
+		_fixed_point_printer.set_scale( scale );
+		finish_sample( _fixed_point_printer.print( value, ptr ), timestamp );
+	}
+
+	/// Passes text of the current scrape to 'sink'.
+	template< typename Sink >
+	void flush( Sink& sink ) const
+		{ sink( _buffer.data(), _length ); }
+
+	/// Accessors to text of the current scrape.
+	const char* data() const
+		{ return _buffer.data(); }
+	size_t size() const
+		{ return _length; }
+	std::string str() const
+		{ return std::string( _buffer.data(), _length ); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__METRICS_WRITER_HPP
@@ -0,0 +1,199 @@
+
+#ifndef ML__PRINTERS__MIXED_RADIX_PRINTER_HPP
+#define ML__PRINTERS__MIXED_RADIX_PRINTER_HPP
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <ostream>
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+
+#include "lr_printer_2_digits.hpp"
+#include "printer_tables.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This printer outputs natural numbers in a mixed-radix system, where
+/// every position has its own radix, like durations (microseconds,
+/// milliseconds, seconds, minutes, hours, days), angles or versioned
+/// counters. With radixes {1000, 1000, 60, 60, 24} and separators
+/// {"", ".", ":", ":", "d "} the number 90061004005 is printed as
+/// "1d 01:01:01.004005".
+/// Instead of powers of one base, weights of the positions are cumulative
+/// products of the radixes, so fields are obtained from left to right, with
+/// one division (and no remainder) per field, as 'lr_printer' does. Every
+/// field is printed in decimal, padded with zeros to the width of its
+/// radix, by pairs of digits. The most significant field is not bounded,
+/// and is printed without padding.
+/// It is a separate class, and not a generalization of '_powers' of
+/// 'lr_printer': there every power yields one digit of the alphabet, while
+/// here a weight yields a whole field (of several decimal digits, with a
+/// separator), so sharing the loop would slow down the regular printers,
+/// and their precomputed per-base tables can't hold per-printer radixes.
+template< typename NumberType >
+class mixed_radix_printer
+{
+public:
+	typedef NumberType number_type;
+	typedef mixed_radix_printer< NumberType > this_type;
+
+	static_assert( has_precomputed_powers< NumberType >::value,
+			"Mixed-radix printer requires a bounded integer type." );
+
+protected:
+	/// Layout of one field (except the most significant one).
+	struct field_layout {
+		/// Weight of the field: product of all radixes below it.
+		number_type weight;
+
+		/// Count of decimal digits of the field.
+		short width;
+
+		/// Separator, printed before the field.
+		std::string separator;
+	};
+
+	/// Layouts of the fields, from the most significant one.
+	std::vector< field_layout > _fields;
+
+	/// Weight of the most significant field.
+	number_type _top_weight = 1;
+
+	/// Maximal length of a printed number.
+	int _length_max = 0;
+
+	/// Powers of 10.
+	const number_type* _decimal_powers = get_precomputed_powers< number_type >( 10 );
+
+	/// Pairs of decimal digits, "000102...99".
+	const char* _pairs = get_precomputed_default_pairs< char >( 10 );
+
+	/// Printer of the most significant field.
+	lr_printer_2_digits< number_type > _top_printer;
+
+	/// The buffer to hold the text, before sending it to output stream or
+	/// output file.
+	mutable std::vector< char > _buffer;
+
+protected:
+	/// Prints 'x' (which must have no more than 'width' digits) with exactly
+	/// 'width' digits, from left to right, by pairs.
+	/// Returns pointer past the last printed digit.
+	char* print_padded( number_type x, short width, char* out ) const {
+		if ( width & 1 ) {
+			// Odd width: the first digit alone
+			const number_type digit = x / _decimal_powers[ width - 1 ];
+			assert( digit < 10 );
+			*(out++) = _pairs[ 2 * (int)digit + 1 ];
+			x -= digit * _decimal_powers[ width - 1 ];
+			--width;
+		}
+		for ( width -= 2; width >= 0; width -= 2 ) {
+			const number_type digits_2 = x / _decimal_powers[ width ];
+			assert( digits_2 < 100 );
+			memcpy( out, _pairs + 2 * (int)digits_2, 2 );
+			out += 2;
+			x -= digits_2 * _decimal_powers[ width ];
+		}
+		return out;
+	}
+
+	/// This is the base printing routine.
+	/// Returns pointer past the last printed character.
+	char* print_to( number_type x, char* out ) const {
+		assert( x >= 0 );
+		const number_type top = x / _top_weight;
+		out = _top_printer.print_digits( top, out );
+		x -= top * _top_weight;
+		for ( const field_layout& field : _fields ) {
+			memcpy( out, field.separator.data(), field.separator.length() );
+			out += field.separator.length();
+			const number_type value = x / field.weight;
+			out = print_padded( value, field.width, out );
+			x -= value * field.weight;
+		}
+		assert( x == 0 );
+		return out;
+	}
+
+	/// Returns count of decimal digits of 'x'.
+	static short count_digits( number_type x ) {
+		short result = 1;
+		for ( ; x >= 10; x /= 10 )
+			++result;
+		return result;
+	}
+
+public:
+	/// Constructor with specification of radixes of all positions, and of
+	/// separators before them, both starting from the least significant
+	/// position. Separator of position 'i' is printed between fields 'i+1'
+	/// and 'i'.
+	mixed_radix_printer( const std::vector< number_type >& radixes,
+			const std::vector< std::string >& separators )
+		{ set_radixes( radixes, separators ); }
+
+	/// Sets radixes of all positions, and separators before them (see the
+	/// constructor).
+	void set_radixes( const std::vector< number_type >& radixes,
+			const std::vector< std::string >& separators ) {
+		assert( radixes.size() == separators.size() );
+		_fields.clear();
+		_top_weight = 1;
+		_length_max = std::numeric_limits< number_type >::digits10 + 1;
+		for ( size_t i = 0; i < radixes.size(); ++i ) {
+			assert( radixes[ i ] >= 2 );
+			const short width = count_digits( radixes[ i ] - 1 );
+			_fields.push_back( { _top_weight, width, separators[ i ] } );
+			_length_max += width + (int)separators[ i ].length();
+			// Product of the radixes must fit in 'number_type'
+			assert( _top_weight
+					<= std::numeric_limits< number_type >::max() / radixes[ i ] );
+			_top_weight *= radixes[ i ];
+		}
+		// Start from the most significant field
+		std::reverse( _fields.begin(), _fields.end() );
+		_buffer.resize( _length_max + 1 );
+	}
+
+	/// Maximal length of a printed number (null-character not included).
+	int get_length_max() const
+		{ return _length_max; }
+
+	/// Prints integer 'x' into buffer 'buf' (of at least 'get_length_max()'
+	/// + 1 characters), and appends null-character.
+	/// Returns number of characters printed (null-character not included).
+	int print( const number_type& x, char* buf ) const
+		{ char* buf_end = print_to( x, buf );
+		  *buf_end = '\0';
+		  return (int)(buf_end - buf); }
+
+	/// Prints integer 'x' into buffer 'buf', without appending null-character.
+	/// Returns pointer past the last printed character.
+	char* print_digits( const number_type& x, char* buf ) const
+		{ return print_to( x, buf ); }
+
+	/// Prints integer 'x' into specified file, without appending any other
+	/// character.
+	/// Returns number of characters printed.
+	int print( const number_type& x, FILE* file ) const
+		{ char* buf_end = print_to( x, _buffer.data() );
+		  fwrite( _buffer.data(), 1, buf_end - _buffer.data(), file );
+		  return (int)(buf_end - _buffer.data()); }
+
+	/// Prints integer 'x' into output stream 'ostr'.
+	std::ostream& print( const number_type& x, std::ostream& ostr ) const
+		{ char* buf_end = print_to( x, _buffer.data() );
+		  return ostr.write( _buffer.data(), buf_end - _buffer.data() ); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__MIXED_RADIX_PRINTER_HPP
@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <cstring>
 #include <cassert>
+#include <algorithm>
 
 namespace ml {
 namespace printers {
@@ -16,12 +17,14 @@ namespace printers {
 /// over the base, and truncation of division over the base.
 /// Digits are written in the buffer from right to left, so there is no 
 /// need to reverse them at the end.
-template< typename NumberType >
+template< typename NumberType, typename CharT = char >
 class modulo_printer
 {
 public:
 	typedef NumberType number_type;
-	typedef modulo_printer< NumberType > this_type;
+	typedef CharT char_type;
+	typedef std::basic_string< CharT > string_type;
+	typedef modulo_printer< NumberType, CharT > this_type;
 
 protected:
 	/// The base, in which numbers will be printed.
@@ -31,14 +34,14 @@ protected:
 	static constexpr short BASE_MAX = 10 + 26;
 
 	/// Digits of the alphabet.
-	char _alphabet[ BASE_MAX ];
+	char_type _alphabet[ BASE_MAX ];
 
 	/// Maximal count of digits that a number can have.
 	/// Assuming 64-bit integer in base 2.
 	static constexpr unsigned short DIGITS_MAX = 64 + 7;
 
 	/// Temporary buffer, used to store produced digits in reverse order.
-	mutable char _buffer[ DIGITS_MAX ];
+	mutable char_type _buffer[ DIGITS_MAX ];
 
 protected:
 	/// This method does the core work: extracting digits from given number
@@ -46,8 +49,8 @@ protected:
 	/// will be no need to do any reverse.
 	/// Returns pointer to where the constructed string starts.
 	/// Note, null-terminating character is not appended by this method.
-	char* print_to_buffer( number_type x ) const {
-		char* ptr = _buffer + DIGITS_MAX - 1;  // Start from the right
+	char_type* print_to_buffer( number_type x ) const {
+		char_type* ptr = _buffer + DIGITS_MAX - 1;  // Start from the right
 		//*--ptr = '\0';  // No need to place null-character here
 		if ( x == 0 ) {  // Check zero case
 			*--ptr = _alphabet[ 0 ];
@@ -60,6 +63,13 @@ protected:
 		return ptr;
 	}
 
+	/// Copies 'alphabet_' into '_alphabet'.
+	void copy_alphabet( const string_type& alphabet_ ) {
+		assert( alphabet_.length() <= (size_t)BASE_MAX );
+		std::char_traits< char_type >::copy( _alphabet, alphabet_.data(), 
+				std::min( alphabet_.length(), (size_t)BASE_MAX ) );
+	}
+
 public:
 	/// Constructor with base specification.
 	explicit modulo_printer( short base_ = 10 )
@@ -68,9 +78,9 @@ public:
 		  prepare_buffer(); }
 
 	/// Constructor with base & alphabet specification.
-	modulo_printer( short base_, const std::string& alphabet_ )
+	modulo_printer( short base_, const string_type& alphabet_ )
 		: _base( base_ ) 
-		{ strcpy_s( _alphabet, alphabet_.c_str() );
+		{ copy_alphabet( alphabet_ );
 		  prepare_buffer(); }
 
 	/// Setter / getter for the base.
@@ -81,8 +91,8 @@ public:
 		{ return _base; }
 
 	/// Setter / getter for the alphabet.
-	void set_alphabet( const std::string& alphabet_ )
-		{ strcpy_s( _alphabet, alphabet_.c_str() ); }
+	void set_alphabet( const string_type& alphabet_ )
+		{ copy_alphabet( alphabet_ ); }
 	const auto& get_alphabet() const
 		{ return _alphabet; }
 
@@ -96,33 +106,37 @@ public:
 		for ( char ch = '0'; ch <= '9' 
 				&& L < _base; 
 				++ch )
-			_alphabet[ L++ ] = ch;
+			_alphabet[ L++ ] = (char_type)ch;
 		// Attach letters
 		for ( char ch = 'a'; ch <= 'z'
 				&& L < _base;
 				++ch )
-			_alphabet[ L++ ] = ch;
+			_alphabet[ L++ ] = (char_type)ch;
 		assert( L == _base );
 	}
 
 	/// Prints integer 'x' into buffer 'buf', and appends null-character.
 	/// Returns number of digits printed (null-character not included).
-	int print( const number_type& x, char* buf ) const
-		{ const char* str = print_to_buffer( x );
-		  strcpy( buf, str );
-		  return (int)(_buffer + DIGITS_MAX - 1 - str); }
+	int print( const number_type& x, char_type* buf ) const
+		{ const char_type* str = print_to_buffer( x );
+		  const int length = (int)(_buffer + DIGITS_MAX - 1 - str);
+		  std::char_traits< char_type >::copy( buf, str, length + 1 );
+		  return length; }
 
 	/// Prints integer 'x' into specified file, without appending any other 
-	/// character.
+	/// character. Characters are written as they are (not converted to 
+	/// multi-byte ones).
 	/// Returns number of digits printed.
 	int print( const number_type& x, FILE* file ) const
-		{ const char* str = print_to_buffer( x );
-		  fprintf( file, "%s", str );
-		  return (int)(_buffer + DIGITS_MAX - 1 - str); }
+		{ const char_type* str = print_to_buffer( x );
+		  const int length = (int)(_buffer + DIGITS_MAX - 1 - str);
+		  fwrite( str, sizeof( char_type ), length, file );
+		  return length; }
 
 	/// Prints integer 'x' into output stream 'ostr'.
-	std::ostream& print( const number_type& x, std::ostream& ostr ) const
-		{ const char* str = print_to_buffer( x );
+	std::basic_ostream< char_type >& print( const number_type& x, 
+			std::basic_ostream< char_type >& ostr ) const
+		{ const char_type* str = print_to_buffer( x );
 		  int length = (int)(_buffer + DIGITS_MAX - 1 - str);
 		  return ostr.write( str, length ); }
 
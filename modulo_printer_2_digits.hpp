@@ -7,6 +7,7 @@
 #include <cstdio>
 #include <cstring>
 #include <cassert>
+#include <algorithm>
 
 namespace ml {
 namespace printers {
@@ -17,12 +18,14 @@ namespace printers {
 /// almost doubling performance.
 /// Digits are written in the buffer from right to left, so there is no 
 /// need to reverse them at the end.
-template< typename NumberType >
+template< typename NumberType, typename CharT = char >
 class modulo_printer_2_digits
 {
 public:
 	typedef NumberType number_type;
-	typedef modulo_printer_2_digits< NumberType > this_type;
+	typedef CharT char_type;
+	typedef std::basic_string< CharT > string_type;
+	typedef modulo_printer_2_digits< NumberType, CharT > this_type;
 
 protected:
 	/// The base, in which numbers will be printed.
@@ -37,20 +40,20 @@ protected:
 	static constexpr short BASE_MAX = 10 + 26;
 
 	/// Digits of the alphabet.
-	char _alphabet[ BASE_MAX ];
+	char_type _alphabet[ BASE_MAX ];
 
 	/// This string contains 2*|N|*|N| characters, each pair correspoinding 
 	/// to pair of alphabet characters, all ordered by alphanumerical.
 	/// This is where from pairs of digits will be selected for printing, 
 	/// instead of selecting digits individually.
-	char _alphabet_sqr[ 2 * BASE_MAX * BASE_MAX ];
+	char_type _alphabet_sqr[ 2 * BASE_MAX * BASE_MAX ];
 
 	/// Maximal count of digits for any printed number.
 	/// Assuming that 64-bit integer is being printed in base 2.
 	static constexpr short DIGITS_MAX = 64 + 5;
 
 	/// Temporary buffer, used to store produced digits.
-	mutable char _buffer[ DIGITS_MAX ];
+	mutable char_type _buffer[ DIGITS_MAX ];
 
 protected:
 	/// This method does the core work: extracting digits from given number
@@ -60,8 +63,8 @@ protected:
 	/// to be odd).
 	/// Returns pointer to where the constructed string starts.
 	/// Note, null-terminating character is not appended by this method.
-	char* print_to_buffer( number_type x ) const {
-		char* ptr = _buffer + DIGITS_MAX - 1;  // Start from the right
+	char_type* print_to_buffer( number_type x ) const {
+		char_type* ptr = _buffer + DIGITS_MAX - 1;  // Start from the right
 		//*--ptr = '\0';  // No need to place null-character here (already present)
 		if ( x == 0 ) {  // Check zero case
 			*--ptr = _alphabet[ 0 ];
@@ -69,9 +72,9 @@ protected:
 		}
 		while ( x >= _base ) {  // We have 2 digits to print
 			short pairs_index = 2 * (x % _base_sqr);
-			// Copy 2 characters
-			*--ptr = _alphabet_sqr[ pairs_index + 1 ];
-			*--ptr = _alphabet_sqr[ pairs_index ];
+			// Copy 2 characters (by a single move)
+			ptr -= 2;
+			memcpy( ptr, _alphabet_sqr + pairs_index, 2 * sizeof( char_type ) );
 			// Truncate last 2 digits
 			x /= _base_sqr;
 		}
@@ -82,6 +85,13 @@ protected:
 		return ptr;
 	}
 
+	/// Copies 'alphabet_' into '_alphabet'.
+	void copy_alphabet( const string_type& alphabet_ ) {
+		assert( alphabet_.length() <= (size_t)BASE_MAX );
+		std::char_traits< char_type >::copy( _alphabet, alphabet_.data(), 
+				std::min( alphabet_.length(), (size_t)BASE_MAX ) );
+	}
+
 public:
 	/// Constructor with base specification.
 	explicit modulo_printer_2_digits( short base_ = 10 )
@@ -90,7 +100,7 @@ public:
 		  setup_buffer_size(); }
 
 	/// Constructor with base & alphabet specification.
-	modulo_printer_2_digits( short base_, const std::string& alphabet_ )
+	modulo_printer_2_digits( short base_, const string_type& alphabet_ )
 		{ set_base( base_ );
 		  set_alphabet( alphabet_ );
 		  setup_buffer_size(); }
@@ -105,10 +115,10 @@ public:
 		{ return _base; }
 
 	/// Setter / getter for the alphabet.
-	void set_alphabet( const std::string& alphabet_ )
-		{ strcpy_s( _alphabet, alphabet_.c_str() );
+	void set_alphabet( const string_type& alphabet_ )
+		{ copy_alphabet( alphabet_ );
 		  calculate_alphabet_sqr(); }
-	const std::string& get_alphabet() const
+	const auto& get_alphabet() const
 		{ return _alphabet; }
 
 	/// Sets up default alphabet (at first decimal digits, then lower alpha 
@@ -121,12 +131,12 @@ public:
 		for ( char ch = '0'; ch <= '9' 
 				&& L < _base; 
 				++ch )
-			_alphabet[ L++ ] = ch;
+			_alphabet[ L++ ] = (char_type)ch;
 		// Attach letters
 		for ( char ch = 'a'; ch <= 'z'
 				&& L < _base; 
 				++ch )
-			_alphabet[ L++ ] = ch;
+			_alphabet[ L++ ] = (char_type)ch;
 		assert( L == _base );
 		// Make further computations
 		calculate_alphabet_sqr();
@@ -134,23 +144,26 @@ public:
 
 	/// Prints integer 'x' into buffer 'buf', and appends null-character.
 	/// Returns number of digits printed (null-character not included).
-	int print( const number_type& x, char* buf ) const
-		{ const char* str = print_to_buffer( x );
-		  strcpy( buf, str );
-		  return (int)(_buffer + DIGITS_MAX - 1 - str); }
+	int print( const number_type& x, char_type* buf ) const
+		{ const char_type* str = print_to_buffer( x );
+		  const int length = (int)(_buffer + DIGITS_MAX - 1 - str);
+		  std::char_traits< char_type >::copy( buf, str, length + 1 );
+		  return length; }
 
 	/// Prints integer 'x' into specified file, without appending any other 
-	/// character.
+	/// character. Characters are written as they are (not converted to 
+	/// multi-byte ones).
 	/// Returns number of digits printed.
 	int print( const number_type& x, FILE* file ) const
-		{ const char* str = print_to_buffer( x );
+		{ const char_type* str = print_to_buffer( x );
 		  int length = (int)(_buffer + DIGITS_MAX - 1 - str);
-		  fprintf( file, "%s", str );
+		  fwrite( str, sizeof( char_type ), length, file );
 		  return length; }
 
 	/// Prints integer 'x' into output stream 'ostr'.
-	std::ostream& print( const number_type& x, std::ostream& ostr ) const
-		{ const char* str = print_to_buffer( x );
+	std::basic_ostream< char_type >& print( const number_type& x, 
+			std::basic_ostream< char_type >& ostr ) const
+		{ const char_type* str = print_to_buffer( x );
 		  int length = (int)(_buffer + DIGITS_MAX - 1 - str);
 		  return ostr.write( str, length ); }
 
@@ -0,0 +1,71 @@
+
+#ifndef ML__PRINTERS__OUTPUT_SINKS_HPP
+#define ML__PRINTERS__OUTPUT_SINKS_HPP
+
+#include <string>
+#include <ostream>
+#include <cstdio>
+#include <cstddef>
+
+namespace ml {
+namespace printers {
+
+
+/// Output sinks receive blocks of already printed characters from writers,
+/// which accumulate the text in their own buffers.
+/// Any callable, accepting '(const char* data, size_t length)' can be used
+/// as a sink.
+
+
+/// Sink, which writes the text into a file.
+class file_sink
+{
+protected:
+	FILE* _file;
+
+public:
+	explicit file_sink( FILE* file_ )
+		: _file( file_ )
+		{}
+
+	void operator()( const char* data, size_t length ) const
+		{ fwrite( data, 1, length, _file ); }
+};
+
+
+/// Sink, which writes the text into an output stream.
+class ostream_sink
+{
+protected:
+	std::ostream* _ostr;
+
+public:
+	explicit ostream_sink( std::ostream& ostr_ )
+		: _ostr( &ostr_ )
+		{}
+
+	void operator()( const char* data, size_t length ) const
+		{ _ostr->write( data, (std::streamsize)length ); }
+};
+
+
+/// Sink, which appends the text to a string.
+class string_sink
+{
+protected:
+	std::string* _str;
+
+public:
+	explicit string_sink( std::string& str_ )
+		: _str( &str_ )
+		{}
+
+	void operator()( const char* data, size_t length ) const
+		{ _str->append( data, length ); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__OUTPUT_SINKS_HPP
@@ -0,0 +1,500 @@
+/// Performance regression gate of the printers.
+/// Measures every printer on every distribution of values (numbers of
+/// every fixed digit length, and of mixed lengths), as several runs, and
+/// writes the results as JSON. If a baseline (results of an earlier
+/// measurement, stored in the repository) is given, compares the runs with
+/// it, and fails if any printer became slower by more than the tolerance,
+/// significantly by the Mann-Whitney test, or if any measurement of the
+/// baseline is missing.
+/// Usage: perf_gate [--output <file>] [--baseline <file>] [--update-baseline]
+///                  [--tolerance <fraction>] [--significance <p-value>]
+///                  [--runs <count>]
+/// Exit code is 0 on success, 1 on regression, 2 on errors.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "modulo_printer.hpp"
+#include "modulo_printer_2_digits.hpp"
+#include "lr_printer.hpp"
+#include "lr_printer_2_digits.hpp"
+#include "lr_printer_batch.hpp"
+#include "memoizing_printer.hpp"
+#include "lean_printer.hpp"
+#include "table_free_printer.hpp"
+#include "printer_composer.hpp"
+#include "json_writer.hpp"
+
+typedef std::chrono::steady_clock clock_type;
+
+/// Count of values, printed by one run.
+const size_t VALUES_PER_RUN = 100'000;
+
+/// Maximal count of decimal digits of 64-bit unsigned numbers.
+const int LENGTH_MAX = 20;
+
+/// Measurement of one printer on one distribution.
+struct measurement
+{
+	std::string printer;
+	std::string distribution;
+
+	/// Digit length of the values, or 0 for mixed lengths.
+	int length = 0;
+
+	/// Time of printing one value, in nanoseconds, by every run.
+	std::vector< double > runs_ns;
+
+	/// Statistics of the runs: median, minimum, maximum, and the first and
+	/// the third quartiles (linearly interpolated between the runs).
+	double median_ns = 0;
+	double min_ns = 0;
+	double max_ns = 0;
+	double q1_ns = 0;
+	double q3_ns = 0;
+
+	/// Key of the measurement, to match it with the baseline.
+	std::string get_key() const
+		{ return printer + "/" + distribution + "/" + std::to_string( length ); }
+
+	/// Calculates statistics of the runs.
+	void calculate_statistics() {
+		if ( runs_ns.empty() )
+			return;
+		std::vector< double > sorted = runs_ns;
+		std::sort( sorted.begin(), sorted.end() );
+		auto quantile = [&sorted]( double q ) {
+			const double pos = q * (sorted.size() - 1);
+			const size_t i = (size_t)pos;
+			return i + 1 < sorted.size()
+					? sorted[ i ] + (pos - i) * (sorted[ i + 1 ] - sorted[ i ])
+					: sorted[ i ];
+		};
+		median_ns = quantile( 0.5 );
+		min_ns = sorted.front();
+		max_ns = sorted.back();
+		q1_ns = quantile( 0.25 );
+		q3_ns = quantile( 0.75 );
+	}
+
+	/// Returns relative noise of the runs: their interquartile range over
+	/// the median (so single outliers, e.g. due to preemption, don't widen
+	/// it).
+	double get_noise() const
+		{ return median_ns > 0 ? (q3_ns - q1_ns) / median_ns : 0; }
+};
+
+/// Returns one-sided p-value of the Mann-Whitney U test of hypothesis, that
+/// runs 'a' are not slower than runs 'b' multiplied by 'factor'.
+/// Uses the normal approximation (with continuity correction), which is
+/// accurate enough from about 5 runs in each.
+double mann_whitney_p_value( const std::vector< double >& a,
+		const std::vector< double >& b, double factor )
+{
+	// Count of pairs, where the run of 'a' is slower (ties count as halves)
+	double u = 0;
+	for ( double x : a )
+		for ( double y : b )
+			u += x > y * factor ? 1 : x == y * factor ? 0.5 : 0;
+	const double n_a = (double)a.size(), n_b = (double)b.size();
+	const double mean = n_a * n_b / 2;
+	const double deviation = std::sqrt( n_a * n_b * (n_a + n_b + 1) / 12 );
+	const double z = (u - mean - 0.5) / deviation;
+	return 0.5 * std::erfc( z / std::sqrt( 2.0 ) );
+}
+
+/// Distribution of values: its name, digit length and the values.
+struct distribution
+{
+	std::string name;
+	int length;
+	std::vector< uint64_t > values;
+};
+
+/// Generates the distributions: values of every digit length, and of mixed
+/// lengths (every length is equally likely).
+std::vector< distribution > generate_distributions()
+{
+	std::mt19937_64 gen( 5'607 );
+	// Range of values of every length
+	uint64_t lows[ LENGTH_MAX + 1 ], highs[ LENGTH_MAX + 1 ];
+	lows[ 1 ] = 0;
+	highs[ 1 ] = 9;
+	for ( int length = 2; length <= LENGTH_MAX; ++length ) {
+		lows[ length ] = highs[ length - 1 ] + 1;
+		highs[ length ] = length < LENGTH_MAX
+				? lows[ length ] * 10 - 1
+				: std::numeric_limits< uint64_t >::max();
+	}
+	auto generate = [&]( int length )
+		{ return lows[ length ] + gen() % (highs[ length ] - lows[ length ] + 1); };
+	std::vector< distribution > result;
+	for ( int length = 1; length <= LENGTH_MAX; ++length ) {
+		result.push_back( { "fixed_length", length, {} } );
+		for ( size_t i = 0; i < VALUES_PER_RUN; ++i )
+			result.back().values.push_back( generate( length ) );
+	}
+	result.push_back( { "mixed_lengths", 0, {} } );
+	for ( size_t i = 0; i < VALUES_PER_RUN; ++i )
+		result.back().values.push_back( generate( (int)(gen() % LENGTH_MAX) + 1 ) );
+	return result;
+}
+
+/// Prints all 'values' into 'out', separated by new-lines.
+/// Returns count of printed characters.
+typedef std::function< size_t ( const std::vector< uint64_t >& values, char* out ) >
+		print_all_function;
+
+/// Returns printing of all values by printer 'p'.
+template< typename PrinterType >
+print_all_function make_print_all( std::shared_ptr< const PrinterType > p )
+{
+	return [p]( const std::vector< uint64_t >& values, char* out ) {
+		char* ptr = out;
+		for ( uint64_t x : values ) {
+			ptr += p->print( x, ptr );
+			*(ptr++) = '\n';
+		}
+		return (size_t)(ptr - out);
+	};
+}
+
+/// Returns printing of all values by batch printer 'p', in batches of
+/// 4096 values, so its temporary arrays remain small.
+print_all_function make_batch_print_all(
+		std::shared_ptr< const ml::printers::lr_printer_batch< uint64_t > > p )
+{
+	return [p]( const std::vector< uint64_t >& values, char* out ) {
+		const size_t batch_size = 4'096;
+		size_t length = 0;
+		for ( size_t i = 0; i < values.size(); i += batch_size )
+			length += p->print( values.data() + i,
+					std::min( batch_size, values.size() - i ), out + length, '\n' );
+		return length;
+	};
+}
+
+/// Printer under measurement.
+struct measured_printer
+{
+	std::string name;
+	print_all_function print_all;
+};
+
+template< typename PrinterType >
+measured_printer make_measured_printer( const char* name )
+	{ return measured_printer{ name, make_print_all(
+			std::make_shared< const PrinterType >() ) }; }
+
+/// Measures every printer of 'printers' on every distribution by 'runs' 
+/// runs (after one warm-up run). The runs are interleaved: every round 
+/// makes one run of every printer on every distribution, so slowdowns of 
+/// the machine, which last longer than a single run, affect all the 
+/// measurements alike, and show up as their noise.
+/// Returns the measurements.
+std::vector< measurement > measure( const std::vector< measured_printer >& printers,
+		const std::vector< distribution >& distributions, int runs )
+{
+	std::vector< measurement > results;
+	for ( const measured_printer& p : printers ) {
+		for ( const distribution& d : distributions ) {
+			results.emplace_back();
+			results.back().printer = p.name;
+			results.back().distribution = d.name;
+			results.back().length = d.length;
+		}
+	}
+	std::vector< char > out( VALUES_PER_RUN * (LENGTH_MAX + 2) );
+	volatile size_t total_length = 0;
+	for ( int run = -1; run < runs; ++run ) {
+		measurement* m = results.data();
+		for ( const measured_printer& p : printers ) {
+			for ( const distribution& d : distributions ) {
+				const clock_type::time_point start_time = clock_type::now();
+				total_length = total_length + p.print_all( d.values, out.data() );
+				const clock_type::duration dur = clock_type::now() - start_time;
+				if ( run >= 0 )
+					m->runs_ns.push_back( std::chrono::duration< double, std::nano >(
+							dur ).count() / d.values.size() );
+				++m;
+			}
+		}
+	}
+	for ( measurement& m : results )
+		m.calculate_statistics();
+	return results;
+}
+
+/// Writes 'results' as JSON into file 'path'.
+/// Returns if succeeded.
+bool write_results( const std::vector< measurement >& results, int runs,
+		const std::string& path )
+{
+	ml::printers::json_writer writer;
+	const auto printer_key = writer.add_key( "printer" );
+	const auto distribution_key = writer.add_key( "distribution" );
+	const auto length_key = writer.add_key( "length" );
+	const auto median_key = writer.add_key( "median_ns" );
+	const auto min_key = writer.add_key( "min_ns" );
+	const auto max_key = writer.add_key( "max_ns" );
+	const auto runs_key = writer.add_key( "runs_ns" );
+	// Nanoseconds are written with 3 fractional digits
+	auto to_ps = []( double ns )
+		{ return (long long)(ns * 1'000 + 0.5); };
+	writer.begin_object();
+	writer.member( writer.add_key( "version" ), 1 );
+	writer.member( writer.add_key( "values_per_run" ), VALUES_PER_RUN );
+	writer.member( writer.add_key( "runs" ), runs );
+	writer.key( "results" );
+	writer.begin_array();
+	for ( const measurement& m : results ) {
+		writer.begin_object();
+		writer.member( printer_key, m.printer );
+		writer.member( distribution_key, m.distribution );
+		writer.member( length_key, m.length );
+		writer.key( median_key );
+		writer.value_fixed_point( to_ps( m.median_ns ), 3 );
+		writer.key( min_key );
+		writer.value_fixed_point( to_ps( m.min_ns ), 3 );
+		writer.key( max_key );
+		writer.value_fixed_point( to_ps( m.max_ns ), 3 );
+		writer.key( runs_key );
+		writer.begin_array();
+		for ( double ns : m.runs_ns )
+			writer.value_fixed_point( to_ps( ns ), 3 );
+		writer.end_array();
+		writer.end_object();
+	}
+	writer.end_array();
+	writer.end_object();
+	std::ofstream file( path, std::ios::binary );
+	file.write( writer.data(), writer.size() );
+	file << '\n';
+	return (bool)file;
+}
+
+/// Returns value of string member 'name' of JSON object 'object' (as the
+/// results are written: without escapes in the values).
+std::string read_string_member( const std::string& object, const char* name )
+{
+	const std::string key = std::string( "\"" ) + name + "\":\"";
+	const size_t start = object.find( key );
+	if ( start == std::string::npos )
+		return std::string();
+	const size_t value_start = start + key.length();
+	return object.substr( value_start, object.find( '"', value_start ) - value_start );
+}
+
+/// Returns value of number member 'name' of JSON object 'object'.
+double read_number_member( const std::string& object, const char* name )
+{
+	const std::string key = std::string( "\"" ) + name + "\":";
+	const size_t start = object.find( key );
+	if ( start == std::string::npos )
+		return 0;
+	return strtod( object.c_str() + start + key.length(), nullptr );
+}
+
+/// Returns values of number array member 'name' of JSON object 'object'.
+std::vector< double > read_numbers_member( const std::string& object, 
+		const char* name )
+{
+	std::vector< double > result;
+	const std::string key = std::string( "\"" ) + name + "\":[";
+	const size_t start = object.find( key );
+	if ( start == std::string::npos )
+		return result;
+	const char* ptr = object.c_str() + start + key.length();
+	while ( *ptr != ']' && *ptr != '\0' ) {
+		char* end;
+		result.push_back( strtod( ptr, &end ) );
+		if ( end == ptr )
+			break;
+		ptr = *end == ',' ? end + 1 : end;
+	}
+	return result;
+}
+
+/// Reads results, written by 'write_results()', from file 'path'.
+/// Returns if succeeded.
+bool read_results( const std::string& path, std::vector< measurement >& results )
+{
+	std::ifstream file( path, std::ios::binary );
+	if ( ! file )
+		return false;
+	std::stringstream content;
+	content << file.rdbuf();
+	const std::string text = content.str();
+	size_t pos = text.find( "\"results\":[" );
+	if ( pos == std::string::npos )
+		return false;
+	// Every result is an object, which contains no other objects
+	while ( (pos = text.find( '{', pos )) != std::string::npos ) {
+		const size_t end = text.find( '}', pos );
+		if ( end == std::string::npos )
+			return false;
+		const std::string object = text.substr( pos, end - pos );
+		measurement m;
+		m.printer = read_string_member( object, "printer" );
+		m.distribution = read_string_member( object, "distribution" );
+		m.length = (int)read_number_member( object, "length" );
+		m.runs_ns = read_numbers_member( object, "runs_ns" );
+		m.calculate_statistics();
+		if ( m.runs_ns.empty() )
+			return false;
+		results.push_back( m );
+		pos = end;
+	}
+	return true;
+}
+
+/// Compares 'results' with 'baseline', and reports every measurement.
+/// A measurement regresses, if its median exceeds median of the baseline
+/// by more than 'tolerance', and its runs are slower than runs of the
+/// baseline, slowed down by 'tolerance', with p-value below 'significance'.
+/// Measurements of the baseline, which are missing from 'results', are
+/// reported and counted too.
+/// Returns count of regressions and missing measurements.
+int compare_results( const std::vector< measurement >& results,
+		const std::vector< measurement >& baseline, double tolerance,
+		double significance )
+{
+	std::map< std::string, const measurement* > results_by_key;
+	for ( const measurement& m : results )
+		results_by_key[ m.get_key() ] = &m;
+	std::map< std::string, const measurement* > baseline_by_key;
+	for ( const measurement& m : baseline )
+		baseline_by_key[ m.get_key() ] = &m;
+	int failures = 0;
+	std::cout << std::fixed << std::setprecision( 3 );
+	for ( const measurement& m : results ) {
+		std::cout << "\t " << m.get_key() << ": " << m.median_ns << " ns (noise "
+				<< m.get_noise() * 100 << "%)";
+		const auto it = baseline_by_key.find( m.get_key() );
+		if ( it == baseline_by_key.end() ) {
+			std::cout << ", not in the baseline" << std::endl;
+			continue;
+		}
+		const measurement& base = *it->second;
+		const double change = m.median_ns / base.median_ns - 1;
+		const double p_value = mann_whitney_p_value( m.runs_ns, base.runs_ns,
+				1 + tolerance );
+		std::cout << ", baseline " << base.median_ns << " ns, "
+				<< std::showpos << change * 100 << std::noshowpos << "%";
+		if ( change > tolerance && p_value < significance ) {
+			std::cout << " REGRESSION (p = " << p_value << ")";
+			++failures;
+		}
+		std::cout << std::endl;
+	}
+	for ( const measurement& m : baseline ) {
+		if ( results_by_key.count( m.get_key() ) == 0 ) {
+			std::cout << "\t " << m.get_key() << ": MISSING from the results" 
+					<< std::endl;
+			++failures;
+		}
+	}
+	return failures;
+}
+
+int main( int argc, char* argv[] )
+{
+	using namespace ml::printers;
+	std::string output_path = "perf_results.json";
+	std::string baseline_path;
+	bool update_baseline = false;
+	double tolerance = 0.15;
+	double significance = 0.01;
+	int runs = 15;
+	for ( int i = 1; i < argc; ++i ) {
+		const std::string arg = argv[ i ];
+		const bool has_value = i + 1 < argc;
+		if ( arg == "--output" && has_value )
+			output_path = argv[ ++i ];
+		else if ( arg == "--baseline" && has_value )
+			baseline_path = argv[ ++i ];
+		else if ( arg == "--update-baseline" )
+			update_baseline = true;
+		else if ( arg == "--tolerance" && has_value )
+			tolerance = atof( argv[ ++i ] );
+		else if ( arg == "--significance" && has_value )
+			significance = atof( argv[ ++i ] );
+		else if ( arg == "--runs" && has_value )
+			runs = std::max( 1, atoi( argv[ ++i ] ) );
+		else {
+			std::cerr << "Usage: " << argv[ 0 ] << " [--output <file>] "
+					"[--baseline <file>] [--update-baseline] "
+					"[--tolerance <fraction>] [--significance <p-value>] "
+					"[--runs <count>]" << std::endl;
+			return 2;
+		}
+	}
+	// Measuring
+	const std::vector< distribution > distributions = generate_distributions();
+	const std::vector< measured_printer > printers = {
+			make_measured_printer< modulo_printer< uint64_t > >( "modulo_printer" ),
+			make_measured_printer< modulo_printer_2_digits< uint64_t > >( 
+					"modulo_printer_2_digits" ),
+			make_measured_printer< lr_printer< uint64_t > >( "lr_printer" ),
+			make_measured_printer< lr_printer_2_digits< uint64_t > >( 
+					"lr_printer_2_digits" ),
+			measured_printer{ "lr_printer_batch", make_batch_print_all(
+					std::make_shared< const lr_printer_batch< uint64_t > >() ) },
+			make_measured_printer< memoizing_printer< uint64_t > >( 
+					"memoizing_printer" ),
+			make_measured_printer< lean_printer< uint64_t > >( "lean_printer" ),
+			make_measured_printer< table_free_printer< uint64_t > >( 
+					"table_free_printer" ),
+			make_measured_printer< composed_printer< uint64_t, modulo_2_digits_engine > >( 
+					"composed_printer<modulo_2_digits>" ),
+			make_measured_printer< composed_printer< uint64_t, lr_2_digits_engine > >( 
+					"composed_printer<lr_2_digits>" ),
+			make_measured_printer< composed_printer< uint64_t, lr_k_digits_engine< 4 > > >( 
+					"composed_printer<lr_k_digits<4>>" ) };
+	const std::vector< measurement > results = measure( printers, distributions, runs );
+	if ( ! write_results( results, runs, output_path ) ) {
+		std::cerr << "Can't write results to '" << output_path << "'." << std::endl;
+		return 2;
+	}
+	std::cout << "Results are written to '" << output_path << "'." << std::endl;
+	if ( baseline_path.empty() )
+		return 0;
+	if ( update_baseline ) {
+		if ( ! write_results( results, runs, baseline_path ) ) {
+			std::cerr << "Can't write baseline '" << baseline_path << "'." << std::endl;
+			return 2;
+		}
+		std::cout << "Baseline '" << baseline_path << "' is updated." << std::endl;
+		return 0;
+	}
+	// Comparing
+	std::vector< measurement > baseline;
+	if ( ! read_results( baseline_path, baseline ) ) {
+		std::cerr << "Can't read baseline '" << baseline_path << "'." << std::endl;
+		return 2;
+	}
+	std::cout << "Comparing with baseline '" << baseline_path << "' (tolerance "
+			<< tolerance * 100 << "%, significance " << significance << "):" << std::endl;
+	const int failures = compare_results( results, baseline, tolerance, significance );
+	if ( failures > 0 ) {
+		std::cout << failures << " regression(s) or missing measurement(s)." << std::endl;
+		return 1;
+	}
+	std::cout << "No regressions." << std::endl;
+	return 0;
+}
@@ -0,0 +1,435 @@
+
+#ifndef ML__PRINTERS__PRINTER_COMPOSER_HPP
+#define ML__PRINTERS__PRINTER_COMPOSER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <ostream>
+#include <cstdio>
+#include <cstring>
+#include <cassert>
+
+#include "printer_tables.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// Here a printer is composed of independent parts, which are all chosen at
+/// compile time:
+///    - the digit engine, which obtains digits of a number in some order,
+///    - the table policy, which owns pairs of alphabet characters,
+///    - the output, which is a buffer, a file, a stream, or any sink (see
+///      'output_sinks.hpp').
+/// So exactly the needed combination can be built, and every choice can be
+/// benchmarked on its own.
+
+
+/// Data, which digit engines receive for printing.
+template< typename NumberType, typename CharT >
+struct engine_data
+{
+	/// The base.
+	short base;
+
+	/// Powers of the base, which fit in 'NumberType'.
+	const NumberType* powers;
+
+	/// Count of 'powers'.
+	short powers_length;
+
+	/// Pairs of characters of the alphabet, 2*base*base characters. Single
+	/// digit 'd' is the character 'pairs[ 2 * d + 1 ]'.
+	const CharT* pairs;
+};
+
+/// Returns count of digits of 'x'.
+template< typename NumberType, typename CharT >
+inline short count_digits( const NumberType& x,
+		const engine_data< NumberType, CharT >& data ) {
+	short length = 1;
+	while ( length < data.powers_length && data.powers[ length ] <= x )
+		++length;
+	return length;
+}
+
+
+/// Digit engines.
+/// Every engine defines:
+///    'print( x, data, out )' - prints digits of natural number 'x' into
+///         'out', and returns pointer past the last printed digit.
+
+/// Obtains digits from right to left, one at a time, by remainders of
+/// division (as 'modulo_printer' does). Count of digits is calculated
+/// beforehand, so digits are placed directly into the output.
+struct modulo_engine
+{
+	template< typename NumberType, typename CharT >
+	static CharT* print( NumberType x,
+			const engine_data< NumberType, CharT >& data, CharT* out ) {
+		assert( x >= 0 );
+		CharT* const end = out + count_digits( x, data );
+		CharT* ptr = end;
+		do {
+			const NumberType quotient = x / data.base;
+			*(--ptr) = data.pairs[ 2 * (int)(x - quotient * data.base) + 1 ];
+			x = quotient;
+		} while ( x != 0 );
+		assert( ptr == out );
+		return end;
+	}
+};
+
+/// Obtains digits from right to left, 2 at a time (as
+/// 'modulo_printer_2_digits' does).
+struct modulo_2_digits_engine
+{
+	template< typename NumberType, typename CharT >
+	static CharT* print( NumberType x,
+			const engine_data< NumberType, CharT >& data, CharT* out ) {
+		assert( x >= 0 );
+		// Square of the base may not fit into narrow types
+		typedef typename std::common_type< NumberType, unsigned >::type wide_type;
+		const wide_type base_sqr = (wide_type)data.base * data.base;
+		wide_type u = (wide_type)x;
+		CharT* const end = out + count_digits( x, data );
+		CharT* ptr = end;
+		while ( u >= base_sqr ) {
+			const wide_type quotient = u / base_sqr;
+			ptr -= 2;
+			memcpy( ptr, data.pairs + 2 * (int)(u - quotient * base_sqr),
+					2 * sizeof( CharT ) );
+			u = quotient;
+		}
+		// Print the first 1 or 2 digit(s)
+		if ( u >= (wide_type)data.base ) {
+			ptr -= 2;
+			memcpy( ptr, data.pairs + 2 * (int)u, 2 * sizeof( CharT ) );
+		}
+		else
+			*(--ptr) = data.pairs[ 2 * (int)u + 1 ];
+		assert( ptr == out );
+		return end;
+	}
+};
+
+/// Obtains digits from left to right, one at a time, by division over
+/// powers of the base (as 'lr_printer' does).
+struct lr_engine
+{
+	template< typename NumberType, typename CharT >
+	static CharT* print( NumberType x,
+			const engine_data< NumberType, CharT >& data, CharT* out ) {
+		assert( x >= 0 );
+		for ( short k = count_digits( x, data ) - 1; k >= 0; --k ) {
+			const int digit = (int)(x / data.powers[ k ]);
+			assert( 0 <= digit && digit < data.base );
+			*(out++) = data.pairs[ 2 * digit + 1 ];
+			x -= digit * data.powers[ k ];
+		}
+		return out;
+	}
+};
+
+/// Obtains digits from left to right, 2 at a time (as 'lr_printer_2_digits'
+/// does).
+struct lr_2_digits_engine
+{
+	template< typename NumberType, typename CharT >
+	static CharT* print( NumberType x,
+			const engine_data< NumberType, CharT >& data, CharT* out ) {
+		assert( x >= 0 );
+		short k = count_digits( x, data ) - 1;  // Index of power of the current digit
+		if ( (k & 1) == 0 ) {
+			// Odd count: the first digit alone
+			const int digit = (int)(x / data.powers[ k ]);
+			*(out++) = data.pairs[ 2 * digit + 1 ];
+			x -= digit * data.powers[ k ];
+			--k;
+		}
+		for ( ; k > 0; k -= 2 ) {
+			const int pair = (int)(x / data.powers[ k - 1 ]);
+			assert( 0 <= pair && pair < data.base * data.base );
+			memcpy( out, data.pairs + 2 * pair, 2 * sizeof( CharT ) );
+			out += 2;
+			x -= pair * data.powers[ k - 1 ];
+		}
+		assert( x == 0 );
+		return out;
+	}
+};
+
+/// Obtains chunks of 'K' digits from left to right, by division over every
+/// K-th power of the base, and prints every chunk from right to left, by
+/// pairs. Divisions inside of a chunk don't depend on the next chunks, so
+/// the chain of dependent divisions is 'K' times shorter.
+template< short K >
+struct lr_k_digits_engine
+{
+	static_assert( K >= 2, "Chunks must have at least 2 digits." );
+
+	/// Prints 'chunk' with exactly 'width' digits.
+	/// Returns pointer past the last printed digit.
+	template< typename NumberType, typename CharT >
+	static CharT* print_chunk( NumberType chunk, short width,
+			const engine_data< NumberType, CharT >& data, CharT* out ) {
+		// Square of the base may not fit into narrow types
+		typedef typename std::common_type< NumberType, unsigned >::type wide_type;
+		const wide_type base_sqr = (wide_type)data.base * data.base;
+		wide_type u = (wide_type)chunk;
+		for ( short i = width; i >= 2; i -= 2 ) {
+			const wide_type quotient = u / base_sqr;
+			memcpy( out + i - 2, data.pairs + 2 * (int)(u - quotient * base_sqr),
+					2 * sizeof( CharT ) );
+			u = quotient;
+		}
+		if ( (width & 1) != 0 )
+			*out = data.pairs[ 2 * (int)u + 1 ];
+		return out + width;
+	}
+
+	template< typename NumberType, typename CharT >
+	static CharT* print( NumberType x,
+			const engine_data< NumberType, CharT >& data, CharT* out ) {
+		assert( x >= 0 );
+		short k = count_digits( x, data );  // Count of remaining digits
+		// The first chunk may be shorter
+		short width = k % K == 0 ? K : k % K;
+		for ( ; k > 0; k -= width, width = K ) {
+			const NumberType chunk = x / data.powers[ k - width ];
+			out = print_chunk( chunk, width, data, out );
+			x -= chunk * data.powers[ k - width ];
+		}
+		assert( x == 0 );
+		return out;
+	}
+};
+
+
+/// Table policies.
+/// Every policy defines:
+///    'char_type' - type of characters,
+///    'set_pairs( base, alphabet )' - sets up pairs for the base, and the
+///         alphabet ('nullptr' for the default one),
+///    'get_pairs()' - returns the pairs.
+
+/// Fills pairs of characters of 'alphabet' for 'base' into 'pairs'.
+template< typename CharT >
+inline void fill_alphabet_pairs( short base, const CharT* alphabet, CharT* pairs ) {
+	for ( short i = 0; i < base; ++i ) {
+		for ( short j = 0; j < base; ++j ) {
+			*(pairs++) = alphabet ? alphabet[ i ] : (CharT)DEFAULT_ALPHABET[ i ];
+			*(pairs++) = alphabet ? alphabet[ j ] : (CharT)DEFAULT_ALPHABET[ j ];
+		}
+	}
+}
+
+/// The pairs are placed inside of the printer, so they are copied with it,
+/// and are near to other data of the printer.
+template< typename CharT >
+class inline_table_policy
+{
+public:
+	typedef CharT char_type;
+
+protected:
+	char_type _pairs[ 2 * TABLES_BASE_MAX * TABLES_BASE_MAX ];
+
+public:
+	void set_pairs( short base, const char_type* alphabet )
+		{ assert( TABLES_BASE_MIN <= base && base <= TABLES_BASE_MAX );
+		  fill_alphabet_pairs( base, alphabet, _pairs ); }
+	const char_type* get_pairs() const
+		{ return _pairs; }
+};
+
+/// The pairs are calculated on the heap, and are shared among copies of
+/// the printer.
+template< typename CharT >
+class shared_table_policy
+{
+public:
+	typedef CharT char_type;
+
+protected:
+	std::shared_ptr< const std::vector< char_type > > _table;
+
+	const char_type* _pairs = nullptr;
+
+public:
+	void set_pairs( short base, const char_type* alphabet ) {
+		assert( TABLES_BASE_MIN <= base && base <= TABLES_BASE_MAX );
+		auto table = std::make_shared< std::vector< char_type > >( 2 * base * base );
+		fill_alphabet_pairs( base, alphabet, table->data() );
+		_pairs = table->data();
+		_table = std::move( table );
+	}
+	const char_type* get_pairs() const
+		{ return _pairs; }
+};
+
+/// The pairs are taken from the precomputed tables, so the printer owns
+/// nothing. Only the default alphabet can be used.
+template< typename CharT >
+class constexpr_table_policy
+{
+public:
+	typedef CharT char_type;
+
+protected:
+	const char_type* _pairs = nullptr;
+
+public:
+	void set_pairs( short base, const char_type* alphabet )
+		{ assert( alphabet == nullptr );  // Custom alphabets have no precomputed tables
+		  (void)alphabet;
+		  _pairs = get_precomputed_default_pairs< char_type >( base ); }
+	const char_type* get_pairs() const
+		{ return _pairs; }
+};
+
+
+/// This printer outputs natural numbers by the digit engine 'DigitEngine',
+/// taking characters from the table policy 'TablePolicy'.
+/// Engines and policies are plain classes, so all the calls are resolved
+/// at compile time, and can be inlined.
+template< typename NumberType,
+		typename DigitEngine = lr_2_digits_engine,
+		typename TablePolicy = constexpr_table_policy< char > >
+class composed_printer : protected TablePolicy
+{
+public:
+	typedef NumberType number_type;
+	typedef DigitEngine engine_type;
+	typedef TablePolicy table_policy_type;
+	typedef typename TablePolicy::char_type char_type;
+	typedef std::basic_string< char_type > string_type;
+	typedef composed_printer< NumberType, DigitEngine, TablePolicy > this_type;
+
+	static_assert( has_precomputed_powers< NumberType >::value,
+			"Composed printer requires a bounded integer type." );
+
+	/// Maximal count of digits of a printed number (in base 2).
+	static constexpr int DIGITS_MAX = std::numeric_limits< number_type >::digits;
+
+protected:
+	/// Data, passed to the engine.
+	engine_data< number_type, char_type > _data;
+
+	/// The alphabet, empty for the default one.
+	string_type _alphabet;
+
+	/// The buffer to hold the digits, before sending them to output stream,
+	/// output file or a sink.
+	mutable char_type _buffer[ DIGITS_MAX ];
+
+protected:
+	/// This is the base printing routine.
+	/// Returns pointer past the last printed digit.
+	char_type* print_to( const number_type& x, char_type* out ) const
+		{ return DigitEngine::print( x, _data, out ); }
+
+	/// Passes the current base and alphabet to the table policy.
+	void update_pairs()
+		{ TablePolicy::set_pairs( _data.base,
+				_alphabet.empty() ? nullptr : _alphabet.data() );
+		  _data.pairs = TablePolicy::get_pairs(); }
+
+public:
+	/// Constructor with base specification.
+	explicit composed_printer( short base_ = 10 )
+		{ set_base( base_ ); }
+
+	/// Constructor with base & alphabet specification.
+	composed_printer( short base_, const string_type& alphabet_ )
+		: _alphabet( alphabet_ )
+		{ set_base( base_ ); }
+
+	/// Copy constructor and assignment. The engine data points to the pairs
+	/// of the table policy, which may be inside of the printer itself, so it
+	/// is pointed to the pairs of the copy. (There are no move operations,
+	/// so moving also copies.)
+	composed_printer( const composed_printer& other )
+		: TablePolicy( other ),
+		  _data( other._data ),
+		  _alphabet( other._alphabet )
+		{ _data.pairs = TablePolicy::get_pairs(); }
+	composed_printer& operator=( const composed_printer& other )
+		{ TablePolicy::operator=( other );
+		  _data = other._data;
+		  _alphabet = other._alphabet;
+		  _data.pairs = TablePolicy::get_pairs();
+		  return *this; }
+
+	/// Setter / getter for the base. Current alphabet must have enough
+	/// characters.
+	void set_base( short base_ )
+		{ assert( TABLES_BASE_MIN <= base_ && base_ <= TABLES_BASE_MAX );
+		  assert( _alphabet.empty() || (size_t)base_ <= _alphabet.length() );
+		  _data.base = base_;
+		  _data.powers = get_precomputed_powers< number_type >( base_ );
+		  _data.powers_length = get_precomputed_powers_length< number_type >( base_ );
+		  update_pairs(); }
+	short get_base() const
+		{ return _data.base; }
+
+	/// Setter / getter for the alphabet.
+	void set_alphabet( const string_type& alphabet_ )
+		{ assert( (size_t)_data.base <= alphabet_.length() );
+		  _alphabet = alphabet_;
+		  update_pairs(); }
+	string_type get_alphabet() const
+		{ return _alphabet.empty()
+				? string_type( DEFAULT_ALPHABET, DEFAULT_ALPHABET + TABLES_BASE_MAX )
+				: _alphabet; }
+
+	/// Sets up default alphabet.
+	void setup_default_alphabet()
+		{ _alphabet.clear();
+		  update_pairs(); }
+
+	/// Prints integer 'x' into buffer 'buf', and appends null-character.
+	/// Returns number of digits printed (null-character not included).
+	int print( const number_type& x, char_type* buf ) const
+		{ char_type* buf_end = print_to( x, buf );
+		  *buf_end = '\0';
+		  return (int)(buf_end - buf); }
+
+	/// Prints integer 'x' into buffer 'buf', without appending null-character.
+	/// Returns pointer past the last printed digit.
+	char_type* print_digits( const number_type& x, char_type* buf ) const
+		{ return print_to( x, buf ); }
+
+	/// Prints integer 'x' into specified file, without appending any other
+	/// character.
+	/// Returns number of digits printed.
+	int print( const number_type& x, FILE* file ) const
+		{ char_type* buf_end = print_to( x, _buffer );
+		  fwrite( _buffer, sizeof( char_type ), buf_end - _buffer, file );
+		  return (int)(buf_end - _buffer); }
+
+	/// Prints integer 'x' into output stream 'ostr'.
+	std::basic_ostream< char_type >& print( const number_type& x,
+			std::basic_ostream< char_type >& ostr ) const
+		{ char_type* buf_end = print_to( x, _buffer );
+		  return ostr.write( _buffer, buf_end - _buffer ); }
+
+	/// Prints integer 'x' into 'sink', which is any callable, accepting
+	/// '(const char_type* data, size_t length)'.
+	/// Returns number of digits printed.
+	template< typename Sink >
+	int print_to_sink( const number_type& x, Sink&& sink ) const
+		{ char_type* buf_end = print_to( x, _buffer );
+		  sink( (const char_type*)_buffer, (size_t)(buf_end - _buffer) );
+		  return (int)(buf_end - _buffer); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__PRINTER_COMPOSER_HPP
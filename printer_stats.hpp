@@ -0,0 +1,274 @@
+
+#ifndef ML__PRINTERS__PRINTER_STATS_HPP
+#define ML__PRINTERS__PRINTER_STATS_HPP
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+namespace ml {
+namespace printers {
+
+
+/// Statistics of the printers: per printer count of calls, count of printed
+/// digits, histogram of digit lengths, count of growths of the lazily
+/// calculated helper data, and calls and time per output sink.
+/// The printers report to it through the 'ML_PRINTERS_STATS_*' macros (see
+/// 'printer_stats_hooks.hpp'), which compile to nothing unless
+/// 'ML_PRINTERS_STATS' is defined.
+/// Every thread updates only its own counters (without any locking), and
+/// counters of all threads are merged on demand, by 'collect()'.
+class printer_stats
+{
+public:
+	/// Output sinks of the printers.
+	enum sink_kind { SINK_BUFFER, SINK_FILE, SINK_STREAM, SINKS_COUNT };
+
+	/// Maximal count of distinct printers (names), which are counted.
+	static constexpr int PRINTERS_MAX = 32;
+
+	/// Maximal length of printed numbers (64-bit numbers in base 2).
+	static constexpr int LENGTH_MAX = 64;
+
+	/// Statistics of one printer.
+	struct printer_counters
+	{
+		/// Name of the printer.
+		std::string name;
+
+		/// Count of calls, and of printed digits.
+		uint64_t calls = 0;
+		uint64_t digits = 0;
+
+		/// Count of calls for every length of printed numbers (longer
+		/// numbers are counted as of 'LENGTH_MAX').
+		uint64_t lengths[ LENGTH_MAX + 1 ] = {};
+
+		/// Count of growths of the helper data.
+		uint64_t helper_data_growths = 0;
+
+		/// Count of calls, and their total time, for every sink.
+		uint64_t sink_calls[ SINKS_COUNT ] = {};
+		uint64_t sink_nanoseconds[ SINKS_COUNT ] = {};
+	};
+
+protected:
+	typedef std::atomic< uint64_t > counter_type;
+
+	/// Counters of one thread.
+	/// They are written only by the owning thread, and are read by
+	/// 'collect()', so relaxed loads and stores are enough (and don't
+	/// lock the bus, as read-modify-write operations would).
+	struct thread_counters
+	{
+		counter_type calls[ PRINTERS_MAX ];
+		counter_type digits[ PRINTERS_MAX ];
+		counter_type lengths[ PRINTERS_MAX ][ LENGTH_MAX + 1 ];
+		counter_type helper_data_growths[ PRINTERS_MAX ];
+		counter_type sink_calls[ PRINTERS_MAX ][ SINKS_COUNT ];
+		counter_type sink_nanoseconds[ PRINTERS_MAX ][ SINKS_COUNT ];
+
+		thread_counters()
+			{ reset(); }
+
+		void reset() {
+			for ( int i = 0; i < PRINTERS_MAX; ++i ) {
+				calls[ i ].store( 0, std::memory_order_relaxed );
+				digits[ i ].store( 0, std::memory_order_relaxed );
+				for ( counter_type& c : lengths[ i ] )
+					c.store( 0, std::memory_order_relaxed );
+				helper_data_growths[ i ].store( 0, std::memory_order_relaxed );
+				for ( int s = 0; s < SINKS_COUNT; ++s ) {
+					sink_calls[ i ][ s ].store( 0, std::memory_order_relaxed );
+					sink_nanoseconds[ i ][ s ].store( 0, std::memory_order_relaxed );
+				}
+			}
+		}
+	};
+
+	/// Increments counter 'c' by 'delta'. Only the owning thread calls it.
+	static void add( counter_type& c, uint64_t delta )
+		{ c.store( c.load( std::memory_order_relaxed ) + delta,
+				std::memory_order_relaxed ); }
+
+	/// Adds value of 'c' to 'total'.
+	static void merge( uint64_t& total, const counter_type& c )
+		{ total += c.load( std::memory_order_relaxed ); }
+
+	/// Registry of the printers and of the threads' counters.
+	struct registry
+	{
+		std::mutex mutex;
+
+		/// Names of the printers, indexed by their ids.
+		std::vector< std::string > names;
+
+		/// Counters of all live threads.
+		std::vector< thread_counters* > threads;
+
+		/// Counters of the threads, which have already exited.
+		thread_counters retired;
+	};
+
+	static registry& get_registry()
+		{ static registry r;
+		  return r; }
+
+	/// Owner of counters of the current thread, which registers them, and
+	/// moves them into 'retired' on thread exit.
+	struct thread_counters_holder
+	{
+		thread_counters counters;
+
+		thread_counters_holder()
+			{ registry& r = get_registry();
+			  std::lock_guard< std::mutex > lock( r.mutex );
+			  r.threads.push_back( &counters ); }
+
+		~thread_counters_holder() {
+			registry& r = get_registry();
+			std::lock_guard< std::mutex > lock( r.mutex );
+			for ( int i = 0; i < PRINTERS_MAX; ++i ) {
+				add( r.retired.calls[ i ], counters.calls[ i ] );
+				add( r.retired.digits[ i ], counters.digits[ i ] );
+				for ( int k = 0; k <= LENGTH_MAX; ++k )
+					add( r.retired.lengths[ i ][ k ], counters.lengths[ i ][ k ] );
+				add( r.retired.helper_data_growths[ i ],
+						counters.helper_data_growths[ i ] );
+				for ( int s = 0; s < SINKS_COUNT; ++s ) {
+					add( r.retired.sink_calls[ i ][ s ], counters.sink_calls[ i ][ s ] );
+					add( r.retired.sink_nanoseconds[ i ][ s ],
+							counters.sink_nanoseconds[ i ][ s ] );
+				}
+			}
+			r.threads.erase( std::find( r.threads.begin(), r.threads.end(),
+					&counters ) );
+		}
+	};
+
+	/// Returns counters of the current thread.
+	static thread_counters& get_thread_counters()
+		{ static thread_local thread_counters_holder holder;
+		  return holder.counters; }
+
+	/// Adds counters 'c' of printer 'id' to 'total'.
+	static void merge( printer_counters& total, const thread_counters& c, int id ) {
+		merge( total.calls, c.calls[ id ] );
+		merge( total.digits, c.digits[ id ] );
+		for ( int k = 0; k <= LENGTH_MAX; ++k )
+			merge( total.lengths[ k ], c.lengths[ id ][ k ] );
+		merge( total.helper_data_growths, c.helper_data_growths[ id ] );
+		for ( int s = 0; s < SINKS_COUNT; ++s ) {
+			merge( total.sink_calls[ s ], c.sink_calls[ id ][ s ] );
+			merge( total.sink_nanoseconds[ s ], c.sink_nanoseconds[ id ][ s ] );
+		}
+	}
+
+public:
+	/// Returns id of printer 'name', registering it on the first call.
+	/// Printers beyond 'PRINTERS_MAX' are all counted under the last id.
+	static int get_printer_id( const char* name ) {
+		registry& r = get_registry();
+		std::lock_guard< std::mutex > lock( r.mutex );
+		for ( size_t i = 0; i < r.names.size(); ++i )
+			if ( r.names[ i ] == name )
+				return (int)i;
+		if ( r.names.size() == PRINTERS_MAX )
+			return PRINTERS_MAX - 1;
+		r.names.push_back( name );
+		return (int)r.names.size() - 1;
+	}
+
+	/// Counts a call of printer 'id' with 'sink', which printed 'digits'
+	/// and took 'nanoseconds'.
+	static void on_print( int id, int sink, int digits, uint64_t nanoseconds ) {
+		assert( 0 <= id && id < PRINTERS_MAX );
+		assert( 0 <= sink && sink < SINKS_COUNT );
+		thread_counters& c = get_thread_counters();
+		add( c.calls[ id ], 1 );
+		add( c.digits[ id ], (uint64_t)digits );
+		add( c.lengths[ id ][ digits < LENGTH_MAX ? digits : LENGTH_MAX ], 1 );
+		add( c.sink_calls[ id ][ sink ], 1 );
+		add( c.sink_nanoseconds[ id ][ sink ], nanoseconds );
+	}
+
+	/// Counts a growth of the helper data of printer 'id'.
+	static void on_helper_data_growth( int id )
+		{ add( get_thread_counters().helper_data_growths[ id ], 1 ); }
+
+	/// Returns statistics of all registered printers, merged over all
+	/// threads (including the exited ones).
+	/// Counters of the live threads are read while they may be updated, so
+	/// the result is consistent per counter, not among counters.
+	static std::vector< printer_counters > collect() {
+		registry& r = get_registry();
+		std::lock_guard< std::mutex > lock( r.mutex );
+		std::vector< printer_counters > result( r.names.size() );
+		for ( size_t i = 0; i < r.names.size(); ++i ) {
+			result[ i ].name = r.names[ i ];
+			merge( result[ i ], r.retired, (int)i );
+			for ( const thread_counters* c : r.threads )
+				merge( result[ i ], *c, (int)i );
+		}
+		return result;
+	}
+
+	/// Returns statistics of printer 'name' (zeros if it is not registered).
+	static printer_counters collect( const std::string& name ) {
+		for ( printer_counters& counters : collect() )
+			if ( counters.name == name )
+				return counters;
+		printer_counters result;
+		result.name = name;
+		return result;
+	}
+
+	/// Resets all the counters. Should be called when the printers are not
+	/// used by other threads.
+	static void reset() {
+		registry& r = get_registry();
+		std::lock_guard< std::mutex > lock( r.mutex );
+		r.retired.reset();
+		for ( thread_counters* c : r.threads )
+			c->reset();
+	}
+};
+
+
+/// Measures duration of a printing call, and reports it on destruction,
+/// together with count of printed digits.
+class printer_stats_scope
+{
+protected:
+	typedef std::chrono::steady_clock clock_type;
+
+	int _id;
+	int _sink;
+	int _digits = 0;
+	clock_type::time_point _start;
+
+public:
+	printer_stats_scope( int id, int sink )
+		: _id( id ), _sink( sink ), _start( clock_type::now() )
+		{}
+
+	~printer_stats_scope()
+		{ printer_stats::on_print( _id, _sink, _digits, (uint64_t)
+				std::chrono::duration_cast< std::chrono::nanoseconds >( 
+						clock_type::now() - _start ).count() ); }
+
+	/// Sets count of printed digits.
+	void set_digits( int digits )
+		{ _digits = digits; }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__PRINTER_STATS_HPP
@@ -0,0 +1,33 @@
+
+#ifndef ML__PRINTERS__PRINTER_STATS_HOOKS_HPP
+#define ML__PRINTERS__PRINTER_STATS_HOOKS_HPP
+
+/// Macros for the printers, to report to 'printer_stats'.
+/// 'ML_PRINTERS_STATS_SCOPE( scope, name, sink )' starts measuring a call of
+/// printer 'name' (a string literal) with 'sink' (one of 'SINK_*'), and
+/// 'ML_PRINTERS_STATS_DIGITS( scope, digits )' sets count of printed digits.
+/// 'ML_PRINTERS_STATS_GROWTH( name )' counts a growth of the helper data.
+/// Unless 'ML_PRINTERS_STATS' is defined, they compile to nothing, and
+/// 'printer_stats.hpp' (with its headers) is not included at all.
+#if defined( ML_PRINTERS_STATS )
+#	include "printer_stats.hpp"
+
+#	define ML_PRINTERS_STATS_ID( name ) \
+		static const int ml_printers_stats_id = \
+				::ml::printers::printer_stats::get_printer_id( name )
+#	define ML_PRINTERS_STATS_SCOPE( scope, name, sink ) \
+		ML_PRINTERS_STATS_ID( name ); \
+		::ml::printers::printer_stats_scope scope( ml_printers_stats_id, \
+				::ml::printers::printer_stats::sink )
+#	define ML_PRINTERS_STATS_DIGITS( scope, digits ) \
+		scope.set_digits( (int)(digits) )
+#	define ML_PRINTERS_STATS_GROWTH( name ) \
+		ML_PRINTERS_STATS_ID( name ); \
+		::ml::printers::printer_stats::on_helper_data_growth( ml_printers_stats_id )
+#else
+#	define ML_PRINTERS_STATS_SCOPE( scope, name, sink ) ((void)0)
+#	define ML_PRINTERS_STATS_DIGITS( scope, digits ) ((void)0)
+#	define ML_PRINTERS_STATS_GROWTH( name ) ((void)0)
+#endif
+
+#endif // ML__PRINTERS__PRINTER_STATS_HOOKS_HPP
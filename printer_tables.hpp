@@ -0,0 +1,154 @@
+
+#ifndef ML__PRINTERS__PRINTER_TABLES_HPP
+#define ML__PRINTERS__PRINTER_TABLES_HPP
+
+#include <limits>
+#include <type_traits>
+
+namespace ml {
+namespace printers {
+
+
+/// Here are helper tables, which are calculated at compile time for every
+/// base, so printers don't need to calculate them when switching the base.
+/// Being constant, all of them are placed in read-only data of the binary
+/// (so they are also shared among processes, through the page cache).
+
+/// Range of bases, for which the tables are calculated.
+constexpr short TABLES_BASE_MIN = 2;
+constexpr short TABLES_BASE_MAX = 10 + 26;
+
+/// The default alphabet: at first decimal digits, then lower alpha
+/// characters.
+constexpr char DEFAULT_ALPHABET[ TABLES_BASE_MAX + 1 ]
+		= "0123456789abcdefghijklmnopqrstuvwxyz";
+
+
+/// Tells if powers table can be precomputed for 'NumberType', i.e. if it
+/// is a bounded integer type.
+template< typename NumberType >
+struct has_precomputed_powers
+	: std::integral_constant< bool,
+			std::numeric_limits< NumberType >::is_specialized
+			&& std::numeric_limits< NumberType >::is_integer
+			&& std::numeric_limits< NumberType >::is_bounded >
+	{};
+
+
+/// Powers of every base, which fit in 'NumberType'.
+template< typename NumberType >
+struct power_tables
+{
+	/// Maximal count of powers for any base (achieved when base=2).
+	static constexpr short DIGITS_MAX = std::numeric_limits< NumberType >::digits;
+
+	/// Powers of every base, starting from 1.
+	NumberType powers[ TABLES_BASE_MAX + 1 ][ DIGITS_MAX ];
+
+	/// Count of powers of every base, which fit in 'NumberType'.
+	short lengths[ TABLES_BASE_MAX + 1 ];
+};
+
+/// Calculates powers tables for all bases.
+template< typename NumberType >
+constexpr power_tables< NumberType > calculate_power_tables() {
+	power_tables< NumberType > tables{};
+	for ( short base = TABLES_BASE_MIN; base <= TABLES_BASE_MAX; ++base ) {
+		NumberType power = 1;
+		short length = 0;
+		tables.powers[ base ][ length++ ] = power;
+		// Append powers, while there is no overflow
+		while ( power <= std::numeric_limits< NumberType >::max() / base ) {
+			power *= base;
+			tables.powers[ base ][ length++ ] = power;
+		}
+		tables.lengths[ base ] = length;
+	}
+	return tables;
+}
+
+
+/// Tables of all pairs of default alphabet characters, for every base.
+/// Table of base 'b' contains 2*b*b characters, each pair corresponding
+/// to pair of digits, all ordered by alphanumerical.
+template< typename CharT >
+struct default_pair_tables
+{
+	/// Total length of all the tables.
+	static constexpr int LENGTH = 2 * (TABLES_BASE_MAX * (TABLES_BASE_MAX + 1)
+			* (2 * TABLES_BASE_MAX + 1) / 6 - 1);
+
+	/// Tables of all bases, one after another.
+	CharT pairs[ LENGTH ];
+
+	/// Where table of every base starts.
+	int offsets[ TABLES_BASE_MAX + 1 ];
+};
+
+/// Calculates tables of default alphabet pairs for all bases.
+template< typename CharT >
+constexpr default_pair_tables< CharT > calculate_default_pair_tables() {
+	default_pair_tables< CharT > tables{};
+	int L = 0;  // Current length of 'pairs'
+	for ( short base = TABLES_BASE_MIN; base <= TABLES_BASE_MAX; ++base ) {
+		tables.offsets[ base ] = L;
+		for ( short i = 0; i < base; ++i ) {
+			for ( short j = 0; j < base; ++j ) {
+				tables.pairs[ L++ ] = (CharT)DEFAULT_ALPHABET[ i ];
+				tables.pairs[ L++ ] = (CharT)DEFAULT_ALPHABET[ j ];
+			}
+		}
+	}
+	return tables;
+}
+
+
+/// Holder of the precomputed powers tables.
+/// It is a template, so the tables can be defined in a header.
+template< typename NumberType >
+struct precomputed_powers
+{
+	static constexpr power_tables< NumberType > tables
+			= calculate_power_tables< NumberType >();
+};
+
+template< typename NumberType >
+constexpr power_tables< NumberType > precomputed_powers< NumberType >::tables;
+
+
+/// Holder of the precomputed default alphabet pairs tables.
+template< typename CharT >
+struct precomputed_default_pairs
+{
+	static constexpr default_pair_tables< CharT > tables
+			= calculate_default_pair_tables< CharT >();
+};
+
+template< typename CharT >
+constexpr default_pair_tables< CharT > precomputed_default_pairs< CharT >::tables;
+
+
+/// Returns precomputed powers of 'base', which fit in 'NumberType'.
+template< typename NumberType >
+inline const NumberType* get_precomputed_powers( short base ) {
+	return precomputed_powers< NumberType >::tables.powers[ base ];
+}
+
+/// Returns count of powers of 'base', which fit in 'NumberType'.
+template< typename NumberType >
+inline short get_precomputed_powers_length( short base ) {
+	return precomputed_powers< NumberType >::tables.lengths[ base ];
+}
+
+/// Returns precomputed table of default alphabet pairs for 'base'.
+template< typename CharT >
+inline const CharT* get_precomputed_default_pairs( short base ) {
+	return precomputed_default_pairs< CharT >::tables.pairs
+			+ precomputed_default_pairs< CharT >::tables.offsets[ base ];
+}
+
+
+}
+}
+
+#endif // ML__PRINTERS__PRINTER_TABLES_HPP
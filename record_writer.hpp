@@ -0,0 +1,245 @@
+
+#ifndef ML__PRINTERS__RECORD_WRITER_HPP
+#define ML__PRINTERS__RECORD_WRITER_HPP
+
+#include <string>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <cstring>
+#include <cstddef>
+#include <cassert>
+
+#include "field_printers.hpp"
+#include "output_sinks.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// Column of integers (possibly negative), printed in base 10.
+template< typename NumberType >
+class integer_column
+{
+public:
+	typedef NumberType value_type;
+
+protected:
+	integer_field_printer< NumberType > _printer;
+
+public:
+	/// Maximal count of characters, which printing of 'x' can produce.
+	size_t max_length( const value_type& ) const
+		{ return integer_field_printer< NumberType >::MAX_LENGTH; }
+
+	/// Prints 'x' into 'out', returns pointer past the last character.
+	char* print( const value_type& x, char* out, char ) const
+		{ return _printer.print( x, out ); }
+};
+
+
+/// Column of fixed-point numbers, which are given as integers, with 'Scale'
+/// last digits of them being the fractional part.
+template< typename NumberType, short Scale >
+class fixed_point_column
+{
+public:
+	typedef NumberType value_type;
+
+protected:
+	fixed_point_field_printer< NumberType > _printer{ Scale };
+
+public:
+	/// Maximal count of characters, which printing of 'x' can produce.
+	size_t max_length( const value_type& ) const
+		{ return fixed_point_field_printer< NumberType >::MAX_LENGTH; }
+
+	/// Prints 'x' into 'out', returns pointer past the last character.
+	char* print( const value_type& x, char* out, char ) const
+		{ return _printer.print( x, out ); }
+};
+
+
+/// Reference to a string, which is printed in a column of strings.
+/// It doesn't own the characters.
+struct string_ref
+{
+	const char* data;
+	size_t length;
+
+	string_ref( const char* data_, size_t length_ )
+		: data( data_ ), length( length_ )
+		{}
+	string_ref( const char* str )
+		: data( str ), length( strlen( str ) )
+		{}
+	string_ref( const std::string& str )
+		: data( str.data() ), length( str.length() )
+		{}
+};
+
+
+/// Column of strings.
+/// Strings, which contain the separator, a quote or a line break, are
+/// enclosed in quotes (with inner quotes being doubled), as CSV requires.
+class string_column
+{
+public:
+	typedef string_ref value_type;
+
+public:
+	/// Maximal count of characters, which printing of 'x' can produce.
+	size_t max_length( const value_type& x ) const
+		{ return 2 * x.length + 2; }
+
+	/// Prints 'x' into 'out', returns pointer past the last character.
+	char* print( const value_type& x, char* out, char separator ) const {
+		const char* const end = x.data + x.length;
+		// Check if quoting is necessary
+		const char* ptr = x.data;
+		while ( ptr != end && *ptr != separator && *ptr != '"'
+				&& *ptr != '\n' && *ptr != '\r' )
+			++ptr;
+		if ( ptr == end ) {
+			memcpy( out, x.data, x.length );
+			return out + x.length;
+		}
+		// Print quoted
+		*(out++) = '"';
+		memcpy( out, x.data, ptr - x.data );
+		out += ptr - x.data;
+		for ( ; ptr != end; ++ptr ) {
+			if ( *ptr == '"' )
+				*(out++) = '"';
+			*(out++) = *ptr;
+		}
+		*(out++) = '"';
+		return out;
+	}
+};
+
+
+/// This class writes records (rows) of a CSV or TSV table, according to
+/// the schema given by 'Columns' (a sequence of 'integer_column',
+/// 'fixed_point_column' and 'string_column').
+/// Rows are accumulated in an internal buffer, which is passed to 'Sink'
+/// when filled up. Before printing a row its maximal length is calculated,
+/// so all fields, separators and the line break are then written without
+/// any further bounds checks.
+template< typename Sink, typename... Columns >
+class record_writer
+{
+public:
+	typedef Sink sink_type;
+	typedef record_writer< Sink, Columns... > this_type;
+
+	/// Count of columns in every row.
+	static constexpr size_t COLUMNS_COUNT = sizeof...( Columns );
+
+	/// Default size of the buffer.
+	static constexpr size_t DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+protected:
+	/// Where the text goes.
+	Sink _sink;
+
+	/// Character, separating the fields.
+	char _separator;
+
+	/// Printers of every column.
+	std::tuple< Columns... > _columns;
+
+	/// The buffer, where the rows are accumulated.
+	std::vector< char > _buffer;
+
+	/// Where the next row will be printed.
+	char* _ptr;
+
+protected:
+	/// Calculates maximal length of the row, consisting of 'values' (with
+	/// separators and the line break).
+	template< size_t... Is >
+	size_t max_row_length( std::index_sequence< Is... >,
+			const typename Columns::value_type&... values ) const {
+		size_t length = COLUMNS_COUNT;
+		int dummy[] = { 0,
+				(length += std::get< Is >( _columns ).max_length( values ), 0)... };
+		(void)dummy;
+		return length;
+	}
+
+	/// Prints the row, consisting of 'values', into 'out'.
+	/// Returns pointer past the printed line break.
+	template< size_t... Is >
+	char* print_row( char* out, std::index_sequence< Is... >,
+			const typename Columns::value_type&... values ) const {
+		int dummy[] = { 0,
+				(out = std::get< Is >( _columns ).print( values, out, _separator ),
+				 *(out++) = (Is + 1 < COLUMNS_COUNT ? _separator : '\n'),
+				 0)... };
+		(void)dummy;
+		return out;
+	}
+
+	/// Makes sure that buffer has at least 'length' free characters.
+	void reserve( size_t length ) {
+		if ( (size_t)(_buffer.data() + _buffer.size() - _ptr) >= length )
+			return;
+		flush();
+		if ( _buffer.size() < length ) {
+			_buffer.resize( length );
+			_ptr = _buffer.data();
+		}
+	}
+
+public:
+	/// Constructor with sink specification, field separator (',' for CSV,
+	/// '\t' for TSV) and size of the internal buffer.
+	explicit record_writer( Sink sink_, char separator_ = ',',
+			size_t buffer_size_ = DEFAULT_BUFFER_SIZE )
+		: _sink( std::move( sink_ ) ),
+		  _separator( separator_ ),
+		  _buffer( buffer_size_ ),
+		  _ptr( _buffer.data() )
+		{}
+
+	record_writer( const this_type& ) = delete;
+	this_type& operator=( const this_type& ) = delete;
+
+	/// Flushes the remaining text.
+	~record_writer()
+		{ flush(); }
+
+	/// Accessors to the columns (e.g. for changing their settings).
+	std::tuple< Columns... >& get_columns()
+		{ return _columns; }
+
+	/// Writes a row, consisting of 'values'.
+	void write_row( const typename Columns::value_type&... values ) {
+		const auto indexes = std::index_sequence_for< Columns... >();
+		reserve( max_row_length( indexes, values... ) );
+		_ptr = print_row( _ptr, indexes, values... );
+		assert( _ptr <= _buffer.data() + _buffer.size() );
+	}
+
+	/// Writes a line without fields, e.g. the header of the table.
+	void write_line( const std::string& line ) {
+		reserve( line.length() + 1 );
+		memcpy( _ptr, line.data(), line.length() );
+		_ptr += line.length();
+		*(_ptr++) = '\n';
+	}
+
+	/// Passes all accumulated text to the sink.
+	void flush() {
+		if ( _ptr != _buffer.data() )
+			_sink( _buffer.data(), (size_t)(_ptr - _buffer.data()) );
+		_ptr = _buffer.data();
+	}
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__RECORD_WRITER_HPP
@@ -0,0 +1,196 @@
+
+#ifndef ML__PRINTERS__RESP_ENCODER_HPP
+#define ML__PRINTERS__RESP_ENCODER_HPP
+
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <cassert>
+
+#include "field_printers.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This class encodes data in Redis serialization protocol (RESP), so
+/// many commands can be accumulated in one buffer and sent together
+/// (pipelined).
+/// All integers (values, and lengths in '*N' and '$N' headers) are printed
+/// by 'lr_printer_2_digits' directly into the buffer. Lengths below
+/// 'HEADER_CACHE_SIZE' are taken from precomputed headers instead.
+class resp_encoder
+{
+public:
+	typedef resp_encoder this_type;
+
+	/// Count of lengths, for which headers are precomputed.
+	static constexpr size_t HEADER_CACHE_SIZE = 1024;
+
+protected:
+	/// Maximal length of a precomputed header.
+	static constexpr size_t CACHED_HEADER_LENGTH_MAX = 8;
+
+	/// Precomputed headers: digits of every length, followed by "\r\n".
+	/// They are stored with fixed stride, so are copied with a single
+	/// 8-byte move.
+	struct header_cache {
+		char texts[ HEADER_CACHE_SIZE ][ CACHED_HEADER_LENGTH_MAX ];
+		unsigned char lengths[ HEADER_CACHE_SIZE ];
+
+		header_cache() {
+			integer_field_printer< size_t > printer;
+			for ( size_t n = 0; n < HEADER_CACHE_SIZE; ++n ) {
+				memset( texts[ n ], 0, CACHED_HEADER_LENGTH_MAX );
+				char* end = printer.print( n, texts[ n ] );
+				memcpy( end, "\r\n", 2 );
+				lengths[ n ] = (unsigned char)(end + 2 - texts[ n ]);
+			}
+		}
+	};
+
+	/// Returns the precomputed headers (calculated on first call).
+	static const header_cache& get_header_cache() {
+		static const header_cache cache;
+		return cache;
+	}
+
+	/// Maximal length of any header: type character, digits and "\r\n".
+	static constexpr size_t HEADER_LENGTH_MAX
+			= 1 + integer_field_printer< long long >::MAX_LENGTH + 2;
+
+	/// The buffer, holding the encoded data.
+	std::vector< char > _buffer;
+
+	/// Length of the data in '_buffer'.
+	size_t _length = 0;
+
+	/// Precomputed headers.
+	const header_cache* _header_cache = &get_header_cache();
+
+	/// Printer of integers.
+	integer_field_printer< long long > _integer_printer;
+
+protected:
+	/// Makes sure that buffer has at least 'length' free characters.
+	/// Returns pointer to where next characters must be written.
+	char* reserve( size_t length ) {
+		if ( _buffer.size() - _length < length )
+			_buffer.resize( std::max( _buffer.size() * 2, _length + length ) );
+		return _buffer.data() + _length;
+	}
+
+	/// Marks the data up to 'ptr' as written.
+	void commit( char* ptr )
+		{ _length = (size_t)(ptr - _buffer.data());
+		  assert( _length <= _buffer.size() ); }
+
+	/// Prints header, consisting of 'type' character and 'n'.
+	/// Requires 'HEADER_LENGTH_MAX' free characters at 'ptr'.
+	/// Returns pointer past the printed header.
+	char* print_header( char* ptr, char type, long long n ) const {
+		*(ptr++) = type;
+		if ( 0 <= n && n < (long long)HEADER_CACHE_SIZE ) {
+			memcpy( ptr, _header_cache->texts[ n ], CACHED_HEADER_LENGTH_MAX );
+			return ptr + _header_cache->lengths[ n ];
+		}
+		ptr = _integer_printer.print( n, ptr );
+		memcpy( ptr, "\r\n", 2 );
+		return ptr + 2;
+	}
+
+	/// Writes every argument of a command as a bulk string.
+	void write_arguments()
+		{}
+	template< typename Arg, typename... Args >
+	void write_arguments( const Arg& arg, const Args&... args )
+		{ write_bulk_string( arg );
+		  write_arguments( args... ); }
+
+public:
+	/// Constructor with specification of initial capacity of the buffer.
+	explicit resp_encoder( size_t capacity_ = 16 * 1024 )
+		: _buffer( capacity_ )
+		{}
+
+	/// Writes header of an array of 'count' elements: "*<count>\r\n".
+	void write_array_header( long long count )
+		{ commit( print_header( reserve( HEADER_LENGTH_MAX ), '*', count ) ); }
+
+	/// Writes a bulk string: "$<length>\r\n<data>\r\n".
+	void write_bulk_string( const char* data, size_t length ) {
+		char* ptr = print_header( reserve( HEADER_LENGTH_MAX + length + 2 ),
+				'$', (long long)length );
+		memcpy( ptr, data, length );
+		ptr += length;
+		memcpy( ptr, "\r\n", 2 );
+		commit( ptr + 2 );
+	}
+	void write_bulk_string( const std::string& str )
+		{ write_bulk_string( str.data(), str.length() ); }
+	void write_bulk_string( const char* str )
+		{ write_bulk_string( str, strlen( str ) ); }
+
+	/// Writes an integer as a bulk string (as integer arguments of commands
+	/// are sent).
+	template< typename NumberType >
+	typename std::enable_if< std::is_integral< NumberType >::value >::type
+	write_bulk_string( NumberType x ) {
+		const long long value = (long long)x;
+		const int length = _integer_printer.length( value );
+		char* ptr = print_header( reserve( 2 * HEADER_LENGTH_MAX ), '$', length );
+		ptr = _integer_printer.print( value, ptr );
+		memcpy( ptr, "\r\n", 2 );
+		commit( ptr + 2 );
+	}
+
+	/// Writes the null bulk string: "$-1\r\n".
+	void write_null_bulk_string()
+		{ commit( print_header( reserve( HEADER_LENGTH_MAX ), '$', -1 ) ); }
+
+	/// Writes an integer: ":<x>\r\n".
+	void write_integer( long long x )
+		{ commit( print_header( reserve( HEADER_LENGTH_MAX ), ':', x ) ); }
+
+	/// Writes a simple string: "+<str>\r\n". It must not contain line breaks.
+	void write_simple_string( const std::string& str ) {
+		char* ptr = reserve( str.length() + 3 );
+		*(ptr++) = '+';
+		memcpy( ptr, str.data(), str.length() );
+		memcpy( ptr + str.length(), "\r\n", 2 );
+		commit( ptr + str.length() + 2 );
+	}
+
+	/// Writes a command (an array of bulk strings), with given arguments
+	/// (strings or integers).
+	template< typename... Args >
+	void write_command( const Args&... args )
+		{ write_array_header( (long long)sizeof...( Args ) );
+		  write_arguments( args... ); }
+
+	/// Passes the encoded data to 'sink'.
+	template< typename Sink >
+	void flush( Sink& sink ) const
+		{ sink( _buffer.data(), _length ); }
+
+	/// Accessors to the encoded data.
+	const char* data() const
+		{ return _buffer.data(); }
+	size_t size() const
+		{ return _length; }
+	std::string str() const
+		{ return std::string( _buffer.data(), _length ); }
+
+	/// Clears the encoded data, keeping the buffer.
+	void clear()
+		{ _length = 0; }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__RESP_ENCODER_HPP
@@ -0,0 +1,165 @@
+
+#ifndef ML__PRINTERS__STRING_COLUMN_BUILDER_HPP
+#define ML__PRINTERS__STRING_COLUMN_BUILDER_HPP
+
+#include <vector>
+#include <thread>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+#include "field_printers.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// Column of strings in the columnar layout (as used by Apache Arrow and
+/// Parquet): characters of all the strings one after another in 'data',
+/// and 'offsets' (having one more element than count of strings) telling
+/// where every string starts. String 'i' occupies
+/// [offsets[ i ], offsets[ i + 1 ]) of 'data'.
+template< typename OffsetType >
+struct string_column_data
+{
+	typedef OffsetType offset_type;
+
+	std::vector< char > data;
+	std::vector< OffsetType > offsets;
+};
+
+
+/// This class converts columns of integers into columns of their decimal
+/// representations, in the columnar layout.
+/// At first exact lengths of all the strings are calculated (by counting
+/// the digits), so the data buffer is allocated once, and then the numbers
+/// are printed into it one after another.
+/// The work can be split among several threads, each one handling its own
+/// chunk of the column.
+template< typename NumberType, typename OffsetType = int32_t >
+class string_column_builder
+{
+public:
+	typedef NumberType number_type;
+	typedef OffsetType offset_type;
+	typedef string_column_builder< NumberType, OffsetType > this_type;
+	typedef string_column_data< OffsetType > column_type;
+
+	/// Minimal count of numbers, handled by a single thread.
+	static constexpr size_t CHUNK_SIZE_MIN = 64 * 1024;
+
+protected:
+	/// Printer of the numbers.
+	/// It doesn't modify its state, so can be used by several threads.
+	integer_field_printer< NumberType > _printer;
+
+	/// Count of threads, to use for building.
+	size_t _threads_count;
+
+protected:
+	/// Calculates lengths of strings for numbers [first, last), and stores
+	/// them in 'offsets' (starting from 'offsets[ 1 ]'), accumulated.
+	/// Returns total length of the strings.
+	size_t calculate_offsets( const number_type* first, const number_type* last,
+			offset_type* offsets ) const {
+		size_t offset = 0;
+		for ( ; first != last; ++first ) {
+			offset += _printer.length( *first );
+			*(++offsets) = (offset_type)offset;
+		}
+		return offset;
+	}
+
+	/// Prints numbers [first, last) one after another into 'out'.
+	void print_numbers( const number_type* first, const number_type* last,
+			char* out ) const {
+		for ( ; first != last; ++first )
+			out = _printer.print( *first, out );
+	}
+
+	/// Runs 'func( chunk_index, first_index, last_index )' for every chunk
+	/// of [0, count), each in a separate thread.
+	template< typename Func >
+	static void for_each_chunk( size_t count, size_t chunks_count, Func func ) {
+		if ( chunks_count == 1 ) {
+			func( 0, 0, count );
+			return;
+		}
+		std::vector< std::thread > threads;
+		threads.reserve( chunks_count - 1 );
+		const size_t chunk_size = (count + chunks_count - 1) / chunks_count;
+		for ( size_t c = 1; c < chunks_count; ++c )
+			threads.emplace_back( func, c,
+					std::min( c * chunk_size, count ),
+					std::min( (c + 1) * chunk_size, count ) );
+		func( 0, 0, std::min( chunk_size, count ) );  // Current thread
+		for ( std::thread& t : threads )
+			t.join();
+	}
+
+public:
+	/// Constructor with specification of count of threads to use.
+	explicit string_column_builder( size_t threads_count_ = 1 )
+		: _threads_count( threads_count_ )
+		{ assert( _threads_count >= 1 ); }
+
+	/// Setter / getter for count of threads.
+	void set_threads_count( size_t threads_count_ )
+		{ assert( threads_count_ >= 1 );
+		  _threads_count = threads_count_; }
+	size_t get_threads_count() const
+		{ return _threads_count; }
+
+	/// Builds column of strings from 'count' numbers of 'nums'.
+	/// Returns if successfully built. Failure might happen only when total
+	/// length of the strings doesn't fit in 'offset_type'.
+	bool build( const number_type* nums, size_t count, column_type& column ) const {
+		const size_t chunks_count = std::max< size_t >( 1,
+				std::min( _threads_count, count / CHUNK_SIZE_MIN ) );
+		// Calculate offsets inside every chunk
+		column.offsets.resize( count + 1 );
+		column.offsets[ 0 ] = 0;
+		offset_type* offsets = column.offsets.data();
+		std::vector< size_t > chunk_lengths( chunks_count );
+		size_t* lengths = chunk_lengths.data();
+		for_each_chunk( count, chunks_count,
+				[this, nums, offsets, lengths]( size_t c, size_t first, size_t last ) {
+					lengths[ c ] = calculate_offsets( 
+							nums + first, nums + last, offsets + first );
+				} );
+		// Shift offsets of every chunk by total length of previous chunks
+		std::vector< offset_type > chunk_starts( chunks_count + 1, 0 );
+		size_t total_length = 0;
+		for ( size_t c = 0; c < chunks_count; ++c ) {
+			total_length += chunk_lengths[ c ];
+			if ( total_length > (size_t)std::numeric_limits< offset_type >::max() )
+				return false;  // Overflow
+			chunk_starts[ c + 1 ] = (offset_type)total_length;
+		}
+		// Allocate the data and print numbers
+		column.data.resize( (size_t)chunk_starts[ chunks_count ] );
+		char* data = column.data.data();
+		const offset_type* starts = chunk_starts.data();
+		for_each_chunk( count, chunks_count,
+				[this, nums, offsets, data, starts](
+						size_t c, size_t first, size_t last ) {
+					print_numbers( nums + first, nums + last, data + starts[ c ] );
+					if ( c != 0 )
+						for ( size_t i = first + 1; i <= last; ++i )
+							offsets[ i ] += starts[ c ];
+				} );
+		return true;
+	}
+
+	/// Builds column of strings from 'nums'.
+	bool build( const std::vector< number_type >& nums, column_type& column ) const
+		{ return build( nums.data(), nums.size(), column ); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__STRING_COLUMN_BUILDER_HPP
@@ -0,0 +1,158 @@
+
+#ifndef ML__PRINTERS__TABLE_FREE_PRINTER_HPP
+#define ML__PRINTERS__TABLE_FREE_PRINTER_HPP
+
+#include <limits>
+#include <ostream>
+#include <type_traits>
+#include <cstdio>
+#include <cassert>
+
+namespace ml {
+namespace printers {
+
+
+/// Returns 'base' raised to power 'k'.
+template< typename UnsignedType >
+constexpr UnsignedType calculate_power( UnsignedType base, int k )
+	{ return k == 0 ? 1 : base * calculate_power( base, k - 1 ); }
+
+/// Returns count of digits of 'x' in 'base'.
+template< typename UnsignedType >
+constexpr int calculate_digits_count( UnsignedType base, UnsignedType x )
+	{ return x < base ? 1 : 1 + calculate_digits_count( base, (UnsignedType)(x / base) ); }
+
+
+/// This printer outputs natural numbers without reading any tables from
+/// memory, so it suits calls, which are rare enough to find the tables
+/// evicted from the caches (when formatting happens once per request, amid
+/// lots of other work).
+/// The base is known at compile time, so:
+///    - count of digits is obtained by comparisons with powers of the base,
+///      which are immediate operands of the instructions,
+///    - pairs of digits are split off by division over square of the base,
+///      and are split into digits by division over the base, both of which
+///      are compiled into multiplications,
+///    - characters are calculated as '0' + d (and 'a' + d - 10 for bases
+///      above 10).
+template< typename NumberType, short Base = 10 >
+class table_free_printer
+{
+public:
+	typedef NumberType number_type;
+	typedef table_free_printer< NumberType, Base > this_type;
+
+	static_assert( std::is_integral< NumberType >::value,
+			"Table-free printer requires an integer type." );
+	static_assert( 2 <= Base && Base <= 10 + 26,
+			"Base must be in range [2, 36]." );
+
+protected:
+	/// Numbers are printed as unsigned, as division of them is cheaper.
+	typedef typename std::make_unsigned< NumberType >::type unsigned_type;
+
+	/// Type of division over square of the base, which may not fit into
+	/// narrow types.
+	typedef typename std::common_type< unsigned_type, unsigned >::type wide_type;
+
+public:
+	/// Maximal count of digits of a printed number.
+	static constexpr int DIGITS_MAX = calculate_digits_count< unsigned_type >(
+			Base, std::numeric_limits< number_type >::max() );
+
+protected:
+	/// Square of the base.
+	static constexpr wide_type BASE_SQR = (wide_type)Base * Base;
+
+	/// The buffer to hold the digits, before sending them to output stream
+	/// or output file.
+	mutable char _buffer[ DIGITS_MAX ];
+
+protected:
+	/// Returns count of digits of 'x', which has at least 'K' digits:
+	/// 'K' plus count of powers of the base, starting from 'K', which don't
+	/// exceed 'x'. Every power is a compile-time constant.
+	template< int K >
+	static int count_digits( unsigned_type x, std::integral_constant< int, K > )
+		{ return (int)(x >= std::integral_constant< unsigned_type,
+				calculate_power< unsigned_type >( Base, K ) >::value)
+				+ count_digits( x, std::integral_constant< int, K + 1 >() ); }
+	static int count_digits( unsigned_type, std::integral_constant< int, DIGITS_MAX > )
+		{ return 1; }
+
+	/// Returns character of digit 'digit'.
+	static char to_char( unsigned digit )
+		{ return Base <= 10 || digit < 10
+				? (char)('0' + digit)
+				: (char)('a' - 10 + digit); }
+
+	/// Prints digits of 'pair' (which is less than square of the base) at
+	/// 'out'.
+	static void print_pair( unsigned pair, char* out )
+		{ const unsigned high = pair / Base;
+		  out[ 0 ] = to_char( high );
+		  out[ 1 ] = to_char( pair - high * Base ); }
+
+	/// This is the base printing routine.
+	/// Digits are obtained from right to left, 2 at a time, and are placed
+	/// directly into the output, as count of them is calculated beforehand.
+	/// Returns pointer past the last printed digit.
+	static char* print_to( number_type x, char* out ) {
+		assert( x >= 0 );
+		wide_type u = (unsigned_type)x;
+		char* const end = out + count_digits( (unsigned_type)x,
+				std::integral_constant< int, 1 >() );
+		char* ptr = end;
+		while ( u >= BASE_SQR ) {
+			const wide_type quotient = u / BASE_SQR;
+			ptr -= 2;
+			print_pair( (unsigned)(u - quotient * BASE_SQR), ptr );
+			u = quotient;
+		}
+		// Print the first 1 or 2 digit(s)
+		if ( u >= (wide_type)Base ) {
+			ptr -= 2;
+			print_pair( (unsigned)u, ptr );
+		}
+		else
+			*(--ptr) = to_char( (unsigned)u );
+		assert( ptr == out );
+		return end;
+	}
+
+public:
+	/// Returns the base.
+	static constexpr short get_base()
+		{ return Base; }
+
+	/// Prints integer 'x' into buffer 'buf', and appends null-character.
+	/// Returns number of digits printed (null-character not included).
+	int print( const number_type& x, char* buf ) const
+		{ char* buf_end = print_to( x, buf );
+		  *buf_end = '\0';
+		  return (int)(buf_end - buf); }
+
+	/// Prints integer 'x' into buffer 'buf', without appending null-character.
+	/// Returns pointer past the last printed digit.
+	char* print_digits( const number_type& x, char* buf ) const
+		{ return print_to( x, buf ); }
+
+	/// Prints integer 'x' into specified file, without appending any other
+	/// character.
+	/// Returns number of digits printed.
+	int print( const number_type& x, FILE* file ) const
+		{ char* buf_end = print_to( x, _buffer );
+		  fwrite( _buffer, 1, buf_end - _buffer, file );
+		  return (int)(buf_end - _buffer); }
+
+	/// Prints integer 'x' into output stream 'ostr'.
+	std::ostream& print( const number_type& x, std::ostream& ostr ) const
+		{ char* buf_end = print_to( x, _buffer );
+		  return ostr.write( _buffer, buf_end - _buffer ); }
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__TABLE_FREE_PRINTER_HPP
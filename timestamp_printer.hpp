@@ -0,0 +1,144 @@
+
+#ifndef ML__PRINTERS__TIMESTAMP_PRINTER_HPP
+#define ML__PRINTERS__TIMESTAMP_PRINTER_HPP
+
+#include <limits>
+#include <cstring>
+#include <cassert>
+
+#include "printer_tables.hpp"
+
+namespace ml {
+namespace printers {
+
+
+/// This class prints timestamps, given as nanoseconds since Unix epoch,
+/// in ISO-8601 / RFC-3339 format: "YYYY-MM-DDThh:mm:ss.fffffffffZ".
+/// All the fields are printed by pairs of digits, taken from the table of
+/// decimal digit pairs (the same which the 2-digit printers use).
+/// Timestamps usually come in increasing order, so the date and hour part
+/// ("YYYY-MM-DDThh:") is cached, and is calculated again only when the
+/// hour changes. Otherwise only minutes, seconds and the fraction are
+/// printed.
+class timestamp_printer
+{
+public:
+	typedef timestamp_printer this_type;
+
+	/// Length of every printed timestamp.
+	static constexpr int LENGTH = 30;
+
+protected:
+	/// Length of the cached prefix: "YYYY-MM-DDThh:".
+	static constexpr int PREFIX_LENGTH = 14;
+
+	static constexpr long long NANOSECONDS_IN_SECOND = 1'000'000'000LL;
+	static constexpr long long NANOSECONDS_IN_MINUTE = 60 * NANOSECONDS_IN_SECOND;
+	static constexpr long long NANOSECONDS_IN_HOUR = 60 * NANOSECONDS_IN_MINUTE;
+
+	/// Pairs of decimal digits, "000102...99".
+	const char* _pairs = get_precomputed_default_pairs< char >( 10 );
+
+	/// Hours since epoch, for which '_prefix' is calculated.
+	mutable long long _prefix_hour = std::numeric_limits< long long >::min();
+
+	/// The cached date and hour part.
+	mutable char _prefix[ PREFIX_LENGTH ];
+
+protected:
+	/// Prints 'x' (which must be in [0, 100)) as 2 digits.
+	void print_pair( unsigned x, char* out ) const {
+		assert( x < 100 );
+		memcpy( out, _pairs + 2 * x, 2 );
+	}
+
+	/// Returns floor of 'x / y', for positive 'y'.
+	static long long floor_div( long long x, long long y ) {
+		const long long q = x / y;
+		return q - (long long)((x % y) < 0);
+	}
+
+	/// Calculates the civil date (in proleptic Gregorian calendar) from
+	/// count of days since epoch.
+	static void calculate_date( long long days,
+			long long& year, unsigned& month, unsigned& day ) {
+		// The algorithm by Howard Hinnant: eras of 400 years, starting
+		// from March 1st
+		days += 719'468;
+		const long long era = floor_div( days, 146'097 );
+		const unsigned day_of_era = (unsigned)(days - era * 146'097);
+		const unsigned year_of_era = (day_of_era - day_of_era / 1'460
+				+ day_of_era / 36'524 - day_of_era / 146'096) / 365;
+		const unsigned day_of_year = day_of_era
+				- (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+		const unsigned month_from_march = (5 * day_of_year + 2) / 153;
+		day = day_of_year - (153 * month_from_march + 2) / 5 + 1;
+		month = month_from_march < 10 ? month_from_march + 3 : month_from_march - 9;
+		year = (long long)year_of_era + era * 400 + (month <= 2);
+	}
+
+	/// Calculates '_prefix' for given hour since epoch.
+	void calculate_prefix( long long hour ) const {
+		const long long days = floor_div( hour, 24 );
+		long long year;
+		unsigned month, day;
+		calculate_date( days, year, month, day );
+		assert( 0 <= year && year <= 9'999 );
+		print_pair( (unsigned)(year / 100), _prefix );
+		print_pair( (unsigned)(year % 100), _prefix + 2 );
+		_prefix[ 4 ] = '-';
+		print_pair( month, _prefix + 5 );
+		_prefix[ 7 ] = '-';
+		print_pair( day, _prefix + 8 );
+		_prefix[ 10 ] = 'T';
+		print_pair( (unsigned)(hour - days * 24), _prefix + 11 );
+		_prefix[ 13 ] = ':';
+		_prefix_hour = hour;
+	}
+
+public:
+	/// Prints timestamp 'epoch_ns' (nanoseconds since epoch) into buffer
+	/// 'buf', and appends null-character.
+	/// Returns number of characters printed (null-character not included).
+	int print( long long epoch_ns, char* buf ) const {
+		const long long hour = floor_div( epoch_ns, NANOSECONDS_IN_HOUR );
+		if ( hour != _prefix_hour )
+			calculate_prefix( hour );
+		memcpy( buf, _prefix, PREFIX_LENGTH );
+		// Minutes and seconds
+		// (calculated in unsigned, as 'hour * NANOSECONDS_IN_HOUR' might not fit)
+		unsigned long long rest = (unsigned long long)epoch_ns
+				- (unsigned long long)hour * NANOSECONDS_IN_HOUR;
+		const unsigned minutes = (unsigned)(rest / NANOSECONDS_IN_MINUTE);
+		rest -= minutes * NANOSECONDS_IN_MINUTE;
+		const unsigned seconds = (unsigned)(rest / NANOSECONDS_IN_SECOND);
+		unsigned fraction = (unsigned)(rest - seconds * NANOSECONDS_IN_SECOND);
+		print_pair( minutes, buf + 14 );
+		buf[ 16 ] = ':';
+		print_pair( seconds, buf + 17 );
+		buf[ 19 ] = '.';
+		// Fraction: 4 pairs and the last digit
+		const unsigned f1 = fraction / 10'000'000;
+		fraction -= f1 * 10'000'000;
+		const unsigned f2 = fraction / 100'000;
+		fraction -= f2 * 100'000;
+		const unsigned f3 = fraction / 1'000;
+		fraction -= f3 * 1'000;
+		const unsigned f4 = fraction / 10;
+		fraction -= f4 * 10;
+		print_pair( f1, buf + 20 );
+		print_pair( f2, buf + 22 );
+		print_pair( f3, buf + 24 );
+		print_pair( f4, buf + 26 );
+		buf[ 28 ] = _pairs[ 2 * fraction + 1 ];
+		buf[ 29 ] = 'Z';
+		buf[ 30 ] = '\0';
+		return LENGTH;
+	}
+};
+
+
+}
+}
+
+#endif // ML__PRINTERS__TIMESTAMP_PRINTER_HPP
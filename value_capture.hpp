@@ -0,0 +1,304 @@
+
+#ifndef ML__PRINTERS__VALUE_CAPTURE_HPP
+#define ML__PRINTERS__VALUE_CAPTURE_HPP
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+namespace ml {
+namespace printers {
+
+
+/// Here is capturing of values, passed to the printers in a running process,
+/// into a corpus file, so the printers can be benchmarked on real data (see
+/// "corpus_replay.cpp").
+/// Values are reported through the 'ML_PRINTERS_CAPTURE_*' macros (see
+/// 'value_capture_hooks.hpp'), which compile to nothing unless
+/// 'ML_PRINTERS_CAPTURE' is defined.
+/// When compiled in but not opened, the capturing costs one relaxed load.
+///
+/// Format of the corpus: 8 bytes of 'CORPUS_MAGIC', then records:
+///    - call-site definition: byte 0, site id (varint), length of the name
+///      (varint), characters of the name,
+///    - value: byte 'base | (negative ? 0x40 : 0)', site id (varint),
+///      magnitude of the value (varint).
+/// Varints are unsigned LEB128, so most records take 3 to 5 bytes.
+
+
+/// One captured value.
+struct corpus_entry
+{
+	/// Magnitude of the value, and its sign.
+	uint64_t magnitude;
+	bool negative;
+
+	/// The base, in which it was printed.
+	short base;
+
+	/// Id of the call-site.
+	int site;
+};
+
+/// Content of a corpus file.
+struct corpus
+{
+	/// Names of the call-sites, indexed by their ids.
+	std::vector< std::string > sites;
+
+	/// The values, in order of capturing (per thread).
+	std::vector< corpus_entry > entries;
+};
+
+
+/// Magic bytes, with which every corpus file starts.
+constexpr char CORPUS_MAGIC[ 8 + 1 ] = "LRPCORP1";
+
+
+/// Appends 'x' to 'out' as unsigned LEB128.
+inline void append_varint( std::vector< unsigned char >& out, uint64_t x ) {
+	while ( x >= 0x80 ) {
+		out.push_back( (unsigned char)(x | 0x80) );
+		x >>= 7;
+	}
+	out.push_back( (unsigned char)x );
+}
+
+/// Reads unsigned LEB128 at 'ptr', not going beyond 'end'.
+/// Returns if succeeded.
+inline bool read_varint( const unsigned char*& ptr, const unsigned char* end, 
+		uint64_t& x ) {
+	x = 0;
+	for ( int shift = 0; ptr != end && shift < 64; shift += 7 ) {
+		const unsigned char byte = *(ptr++);
+		x |= (uint64_t)(byte & 0x7f) << shift;
+		if ( (byte & 0x80) == 0 )
+			return true;
+	}
+	return false;
+}
+
+
+/// Writer of the corpus, shared by all threads of the process.
+/// Every thread encodes its values into own buffer, which is written to the
+/// file when it is full, when the thread exits, or by 'flush()' (from that
+/// thread). So the file is locked once per thousands of values.
+class value_capture
+{
+public:
+	/// Size of the buffer of every thread, after which it is written.
+	static constexpr size_t THREAD_BUFFER_SIZE = 1 << 16;
+
+	/// Maximal base, which fits in the value record.
+	static constexpr short BASE_MAX = 0x3f;
+
+	/// Maximal count of call-sites.
+	static constexpr int SITES_MAX = 1 << 16;
+
+protected:
+	/// Buffer of one thread, and count of its calls (for sampling).
+	struct thread_buffer
+	{
+		std::vector< unsigned char > data;
+		uint64_t calls = 0;
+
+		~thread_buffer()
+			{ write( data ); }
+	};
+
+	/// State of the writer.
+	struct state
+	{
+		std::mutex mutex;
+
+		/// Is set while the file is open.
+		std::atomic< bool > enabled{ false };
+
+		/// Every 'sample_period'-th value of each thread is captured.
+		std::atomic< uint64_t > sample_period{ 1 };
+
+		/// The corpus file.
+		FILE* file = nullptr;
+
+		/// Names of the registered call-sites.
+		std::vector< std::string > sites;
+	};
+
+	static state& get_state()
+		{ static state s;
+		  return s; }
+
+	static thread_buffer& get_thread_buffer()
+		{ static thread_local thread_buffer buffer;
+		  return buffer; }
+
+	/// Appends definition of call-site 'id' to 'out'.
+	static void append_site( std::vector< unsigned char >& out, int id, 
+			const std::string& name ) {
+		out.push_back( 0 );
+		append_varint( out, (uint64_t)id );
+		append_varint( out, name.length() );
+		out.insert( out.end(), name.begin(), name.end() );
+	}
+
+	/// Writes 'data' (whole records) to the file, and clears it.
+	static void write( std::vector< unsigned char >& data ) {
+		if ( data.empty() )
+			return;
+		state& s = get_state();
+		std::lock_guard< std::mutex > lock( s.mutex );
+		if ( s.file != nullptr )
+			fwrite( data.data(), 1, data.size(), s.file );
+		data.clear();
+	}
+
+public:
+	/// Starts capturing into file 'path' (which is overwritten), every
+	/// 'sample_period'-th value of each thread.
+	/// Returns if the file is opened.
+	static bool open( const char* path, uint64_t sample_period = 1 ) {
+		assert( sample_period >= 1 );
+		close();
+		state& s = get_state();
+		std::lock_guard< std::mutex > lock( s.mutex );
+		s.file = fopen( path, "wb" );
+		if ( s.file == nullptr )
+			return false;
+		// Sites, registered before, may be reported in the new file
+		std::vector< unsigned char > header( CORPUS_MAGIC, CORPUS_MAGIC + 8 );
+		for ( size_t i = 0; i < s.sites.size(); ++i )
+			append_site( header, (int)i, s.sites[ i ] );
+		fwrite( header.data(), 1, header.size(), s.file );
+		s.sample_period.store( sample_period, std::memory_order_relaxed );
+		s.enabled.store( true, std::memory_order_release );
+		return true;
+	}
+
+	/// Stops capturing, writing buffer of the current thread. Values, still
+	/// buffered by other live threads, are dropped.
+	static void close() {
+		flush();
+		state& s = get_state();
+		std::lock_guard< std::mutex > lock( s.mutex );
+		s.enabled.store( false, std::memory_order_relaxed );
+		if ( s.file != nullptr ) {
+			fclose( s.file );
+			s.file = nullptr;
+		}
+	}
+
+	/// Writes buffer of the current thread to the file.
+	static void flush()
+		{ write( get_thread_buffer().data ); }
+
+	/// Tells if capturing is on.
+	static bool is_enabled()
+		{ return get_state().enabled.load( std::memory_order_relaxed ); }
+
+	/// Returns id of call-site 'name', registering it on the first call.
+	/// Call-sites beyond 'SITES_MAX' all get the last id.
+	static int get_site_id( const char* name ) {
+		state& s = get_state();
+		std::lock_guard< std::mutex > lock( s.mutex );
+		for ( size_t i = 0; i < s.sites.size(); ++i )
+			if ( s.sites[ i ] == name )
+				return (int)i;
+		if ( s.sites.size() == SITES_MAX )
+			return SITES_MAX - 1;
+		s.sites.push_back( name );
+		if ( s.file != nullptr ) {
+			std::vector< unsigned char > record;
+			append_site( record, (int)s.sites.size() - 1, s.sites.back() );
+			fwrite( record.data(), 1, record.size(), s.file );
+		}
+		return (int)s.sites.size() - 1;
+	}
+
+	/// Captures 'value', printed in 'base' at call-site 'site' (if it is
+	/// sampled). Only integers of up to 64 bits are captured, values of
+	/// other types are ignored.
+	template< typename NumberType >
+	static void capture( int site, const NumberType& value, short base )
+		{ capture( site, value, base, std::integral_constant< bool, 
+				std::is_integral< NumberType >::value 
+				&& sizeof( NumberType ) <= sizeof( uint64_t ) >() ); }
+
+protected:
+	template< typename NumberType >
+	static void capture( int, const NumberType&, short, std::false_type )
+		{}
+
+	template< typename NumberType >
+	static void capture( int site, const NumberType& value, short base, 
+			std::true_type ) {
+		assert( 2 <= base && base <= BASE_MAX );
+		thread_buffer& buffer = get_thread_buffer();
+		if ( ++buffer.calls % get_state().sample_period.load( 
+				std::memory_order_relaxed ) != 0 )
+			return;
+		const bool negative = value < 0;
+		const uint64_t magnitude = negative 
+				? 0 - (uint64_t)value : (uint64_t)value;
+		buffer.data.push_back( (unsigned char)(base | (negative ? 0x40 : 0)) );
+		append_varint( buffer.data, (uint64_t)site );
+		append_varint( buffer.data, magnitude );
+		if ( buffer.data.size() >= THREAD_BUFFER_SIZE )
+			write( buffer.data );
+	}
+};
+
+
+/// Reads corpus from file 'path' into 'result'.
+/// Returns if succeeded (otherwise the file is not a valid corpus).
+inline bool read_corpus( const char* path, corpus& result ) {
+	result = corpus();
+	FILE* file = fopen( path, "rb" );
+	if ( file == nullptr )
+		return false;
+	std::vector< unsigned char > data;
+	unsigned char chunk[ 1 << 16 ];
+	size_t length;
+	while ( (length = fread( chunk, 1, sizeof( chunk ), file )) > 0 )
+		data.insert( data.end(), chunk, chunk + length );
+	fclose( file );
+	if ( data.size() < 8 || memcmp( data.data(), CORPUS_MAGIC, 8 ) != 0 )
+		return false;
+	const unsigned char* ptr = data.data() + 8;
+	const unsigned char* const end = data.data() + data.size();
+	while ( ptr != end ) {
+		const unsigned char tag = *(ptr++);
+		uint64_t site, x;
+		if ( ! read_varint( ptr, end, site ) || ! read_varint( ptr, end, x ) )
+			return false;
+		if ( site >= (uint64_t)value_capture::SITES_MAX )
+			return false;
+		if ( tag == 0 ) {
+			// Call-site definition
+			if ( (uint64_t)(end - ptr) < x )
+				return false;
+			if ( result.sites.size() <= site )
+				result.sites.resize( site + 1 );
+			result.sites[ site ].assign( (const char*)ptr, (size_t)x );
+			ptr += x;
+		}
+		else {
+			// Value
+			const corpus_entry entry{ x, (tag & 0x40) != 0, 
+					(short)(tag & 0x3f), (int)site };
+			result.entries.push_back( entry );
+		}
+	}
+	return true;
+}
+
+
+}
+}
+
+#endif // ML__PRINTERS__VALUE_CAPTURE_HPP
@@ -0,0 +1,33 @@
+
+#ifndef ML__PRINTERS__VALUE_CAPTURE_HOOKS_HPP
+#define ML__PRINTERS__VALUE_CAPTURE_HOOKS_HPP
+
+/// Macros for capturing values, printed by the printers.
+/// 'ML_PRINTERS_CAPTURE_AT( site, value, base )' captures 'value', printed
+/// in 'base' at call-site 'site' (a string literal), and 
+/// 'ML_PRINTERS_CAPTURE_HERE( value, base )' uses file and line of the call
+/// as the call-site.
+/// Unless 'ML_PRINTERS_CAPTURE' is defined, they compile to nothing, and
+/// 'value_capture.hpp' (with its headers) is not included at all.
+#define ML_PRINTERS_CAPTURE_STRINGIZE_( x ) #x
+#define ML_PRINTERS_CAPTURE_STRINGIZE( x ) ML_PRINTERS_CAPTURE_STRINGIZE_( x )
+#if defined( ML_PRINTERS_CAPTURE )
+#	include "value_capture.hpp"
+
+#	define ML_PRINTERS_CAPTURE_AT( site, value, base ) \
+		do { \
+			if ( ::ml::printers::value_capture::is_enabled() ) { \
+				static const int ml_printers_capture_site = \
+						::ml::printers::value_capture::get_site_id( site ); \
+				::ml::printers::value_capture::capture( \
+						ml_printers_capture_site, value, base ); \
+			} \
+		} while ( false )
+#else
+#	define ML_PRINTERS_CAPTURE_AT( site, value, base ) ((void)0)
+#endif
+#define ML_PRINTERS_CAPTURE_HERE( value, base ) \
+	ML_PRINTERS_CAPTURE_AT( __FILE__ ":" ML_PRINTERS_CAPTURE_STRINGIZE( __LINE__ ), \
+			value, base )
+
+#endif // ML__PRINTERS__VALUE_CAPTURE_HOOKS_HPP